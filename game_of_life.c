@@ -10,21 +10,112 @@
 //================
 /// INCLUDES
 //================
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <inttypes.h>
+#include <stddef.h>
 #include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <zlib.h>
 
 //================
 /// DEFINES
 //================
 #define STANDARD_WIDTH 10
 #define STANDARD_HEIGHT 10
-#define USAGE_PROMPT "Usage: ./gol [-f <filename>]\n"
+#define USAGE_PROMPT "Usage: ./gol [-f <filename>|- | --random <w>x<h> [--density <p>] [--seed <n>]] [--torus] [options]\n" \
+                     "       ./gol --bench <output.json> [--bench-max-size <n>] [options]\n" \
+                     "       ./gol --check <trials> [--seed <n>] [options]\n" \
+                     "       ./gol --ensemble <list.txt> | --soups <count> [--seed <n>] [--soup-size <w>x<h>]\n" \
+                     "             [--density <p>] [--max-generations <n>] [--torus] [options]\n" \
+                     "       ./gol --census <soups> [--seed <n>] [--soup-size <w>x<h>] [--density <p>]\n" \
+                     "             [--max-generations <n>] [options]\n" \
+                     "       ./gol [-f <filename> | --random <w>x<h>] --analyze <output.json> [options]\n" \
+                     "       ./gol [-f <filename> | --random <w>x<h>] --generations <n> --output <filename>[.mc|.lif] [options]\n" \
+                     "       ./gol --replay <file> [--seek <g>] [--replay-step <n>] [--output <filename>] [options]\n" \
+                     "Options: --engine <name>, --threads <n>, --numa, --perf-counters,\n" \
+                     "         --huge-pages off|thp|hugetlb, --block-generations <k>,\n" \
+                     "         --background-compress (input may be gzipped, outputs ending in .gz are),\n" \
+                     "         --record <file> [--keyframe-interval <k>] (with --generations ends after the jump),\n" \
+                     "         --history-budget <MiB> (generations kept for stepping back, 0 keeps none),\n" \
+                     "         --render cells|half|braille (1x1, 1x2 or 2x4 cells per character)\n"
 #define INFO_DEFAULT_FILE "-> Info: Using standard configuration file \"%s\"\n"
 #define ERROR_NO_FILE "-> Error: Configuration file \"%s\" does not exist!\n"
 #define DEFAULT_CONFIG_PATH "default.txt"
+#define BOARD_ALIGNMENT 64
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define HUGE_PAGE_THRESHOLD (16 * HUGE_PAGE_SIZE)
+#define MAX_WORKERS 1024
+#define NUMA_NODE_PATH "/sys/devices/system/node/node%zu/cpulist"
+#define CELL_DEAD 0
+#define CELL_ALIVE 1
+#define GOL_VERSION "1.1.0"
+#define BENCH_SEED 0x5eed0f11feULL
+#define CHECK_MAX_HEIGHT 80
+#define CHECK_GENERATIONS 64
+#define CHECK_MAX_STEP 20
+#define BLOCK_TILE_HEIGHT 64
+#define BLOCK_TILE_WIDTH 512
+#define BLOCK_DEFAULT_GENERATIONS 8
+#define BLOCK_MAX_GENERATIONS 64
+#define PIPELINE_SPINS 64
+#define ACTIVITY_TILE_HEIGHT 32
+#define ACTIVITY_TILE_WIDTH 128
+#define SLICED_LANES 64
+#define JUMP_DEFAULT_ENGINE "parallel"
+#define MACROCELL_HEADER "[M2]"
+#define MACROCELL_LEAF_LEVEL 3
+#define MACROCELL_MAX_LEVEL 62
+#define MACROCELL_TABLE_SIZE 4096
+#define MACROCELL_MAX_CELLS ((size_t) 1 << 36)
+#define LIFE106_HEADER "#Life 1.06"
+#define READ_CHUNK_SIZE (1 << 20)
+#define GZIP_MAGIC "\x1f\x8b"
+#define COMPRESS_BLOCKS 4
+#define COMPRESS_BLOCK_SIZE (1 << 20)
+#define PROGRESS_INTERVAL 0.25
+#define RECORD_MAGIC "GOLREC01"
+#define RECORD_SLOTS 4
+#define RECORD_ALIGNMENT 8
+#define RECORD_DEFAULT_INTERVAL 256
+#define HISTORY_DEFAULT_BUDGET 64
+#define INTERACTIVE_DELAY_MS 1000
+#define INTERACTIVE_MIN_DELAY_MS 1
+#define INTERACTIVE_MAX_DELAY_MS 8000
+#define SNAPSHOT_PATH "snapshot-%zu.txt"
+#define TERMINAL_PATH "/dev/tty"
+#define KEYS_PROMPT "-> Keys: space pause/resume, n step, b step back, +/- speed, s snapshot, q quit,\n" \
+                    "         arrows or h/j/k/l pan, o/i zoom out/in, f fit the board, r render mode\n"
+#define KEY_RESIZE 0x100
+#define VIEWPORT_RESERVED_ROWS 4
+#define VIEWPORT_SAMPLES 8
+#define CLASSIFY_MAX_PERIOD 64
+#define CLASSIFY_MIN_MARGIN 4
+#define SHAPE_CACHE_SIZE 1024
+#define CENSUS_TABLE_SIZE 256
+#define ENSEMBLE_DEFAULT_SIZE 64
+#define ENSEMBLE_DEFAULT_DENSITY 0.35
+#define ENSEMBLE_DEFAULT_GENERATIONS 10000
+#define TASK_EMPTY SIZE_MAX
+#define TASK_ABORT (SIZE_MAX - 1)
+#define ERROR_NO_ENGINE "-> Error: Unknown engine \"%s\"!\n"
+#define INFO_NO_COUNTERS "-> Info: Hardware counters unavailable for %s (%s)\n"
 
 //================
 /// ENUMS
@@ -35,6 +126,52 @@ typedef enum _ProgramReturn_
   ERROR 
 } ProgramReturn;
 
+typedef enum _PerfEvent_
+{
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_CACHE_REFERENCES,
+  PERF_CACHE_MISSES,
+  PERF_BRANCHES,
+  PERF_BRANCH_MISSES,
+  PERF_EVENT_COUNT
+} PerfEvent;
+
+typedef enum _Topology_
+{
+  TOPOLOGY_BOUNDED,
+  TOPOLOGY_TORUS
+} Topology;
+
+typedef enum _HugePageMode_
+{
+  HUGE_PAGES_OFF,
+  HUGE_PAGES_THP,
+  HUGE_PAGES_HUGETLB
+} HugePageMode;
+
+typedef enum _ArenaBacking_
+{
+  ARENA_HEAP,
+  ARENA_MMAP,
+  ARENA_HUGETLB
+} ArenaBacking;
+
+typedef enum _ObjectKind_
+{
+  OBJECT_UNKNOWN,
+  OBJECT_STILL_LIFE,
+  OBJECT_OSCILLATOR,
+  OBJECT_SPACESHIP
+} ObjectKind;
+
+typedef enum _WorkloadKind_
+{
+  WORKLOAD_SOUP,
+  WORKLOAD_TILES,
+  WORKLOAD_PATTERN
+} WorkloadKind;
+
 //================
 /// STRUCTS
 //================
@@ -44,265 +181,7661 @@ typedef struct _Neighbour_
   int offset_x;
 } Neighbour;
 
-typedef struct _Cell_
+// The board header, both generations with their halos and the tile activity
+// flags live in one arena. Cell (0, 0) of a generation starts a 64 byte
+// aligned row, the byte before it and the one after the last column belong to
+// the halo, as do the rows -1 and height. Halos are dead for bounded boards and
+// mirror the opposite edge for torus boards. The activity flags record which
+// tiles changed in the last generation; they are only trusted while
+// activity_generation matches generation. The work-stealing engine keeps its
+// deques and active tile list with the board, allocated on its first use.
+typedef struct _Board_
+{
+  size_t height;
+  size_t width;
+  size_t stride;
+  Topology topology;
+  uint8_t *current;
+  uint8_t *next;
+  size_t arena_size;
+  ArenaBacking backing;
+  size_t generation;
+  size_t tile_rows;
+  size_t tile_columns;
+  uint8_t *changed;
+  uint8_t *new_changed;
+  size_t activity_generation;
+  struct _StealPass_ *steal;
+} Board;
+
+// Engines advancing several generations at once more cheaply than one by one
+// provide advance, the others are stepped through update.
+typedef struct _Engine_
+{
+  const char *name;
+  void (*update)(Board *board);
+  void (*advance)(Board *board, size_t generations);
+} Engine;
+
+typedef enum _RenderMode_
+{
+  RENDER_CELLS,
+  RENDER_HALF,
+  RENDER_BRAILLE,
+  RENDER_MODE_COUNT
+} RenderMode;
+
+typedef struct _Options_
+{
+  char *file_path;
+  const Engine *engine;
+  Topology topology;
+  int perf_counters;
+  char *bench_path;
+  size_t bench_max_size;
+  size_t check_trials;
+  uint64_t seed;
+  size_t threads;
+  char *ensemble_path;
+  size_t soup_count;
+  size_t soup_width;
+  size_t soup_height;
+  double density;
+  size_t max_generations;
+  size_t random_width;
+  size_t random_height;
+  size_t census_soups;
+  char *analyze_path;
+  size_t generations;
+  char *output_path;
+  char *record_path;
+  size_t keyframe_interval;
+  char *replay_path;
+  size_t seek_generation;
+  long long replay_step;
+  size_t history_budget;
+  RenderMode render_mode;
+} Options;
+
+// The calling thread is worker 0, the pool threads are workers 1 to size - 1.
+// A job is handed out by passing the start barrier and collected at the done
+// barrier.
+typedef struct _WorkerPool_
+{
+  size_t size;
+  size_t node_count;
+  int cpus[MAX_WORKERS];
+  pthread_t threads[MAX_WORKERS];
+  pid_t thread_ids[MAX_WORKERS];
+  pthread_barrier_t start;
+  pthread_barrier_t done;
+  void (*job)(void *argument, size_t worker);
+  void *argument;
+  int stopping;
+} WorkerPool;
+
+typedef struct _BlockPass_
+{
+  Board *board;
+  size_t generations;
+  size_t tile_rows;
+  size_t tile_columns;
+  atomic_size_t next_tile;
+} BlockPass;
+
+// Generations completed by one band, padded to keep bands off each other's
+// cache lines
+typedef struct _BandProgress_
+{
+  atomic_size_t generation;
+  char padding[BOARD_ALIGNMENT - sizeof(atomic_size_t)];
+} BandProgress;
+
+typedef struct _PipelinePass_
+{
+  Board *board;
+  size_t generations;
+  size_t band_count;
+  BandProgress *progress;
+} PipelinePass;
+
+// Chase-Lev work-stealing deque of tile indices. The owner pushes and takes
+// at the bottom, thieves steal from the top.
+typedef struct _TaskDeque_
+{
+  atomic_long top;
+  char top_padding[BOARD_ALIGNMENT - sizeof(atomic_long)];
+  atomic_long bottom;
+  char bottom_padding[BOARD_ALIGNMENT - sizeof(atomic_long)];
+  atomic_size_t *tasks;
+  size_t capacity;
+} TaskDeque;
+
+typedef struct _StealPass_
+{
+  Board *board;
+  size_t *active_tiles;
+  size_t active_count;
+  TaskDeque *deques;
+  atomic_size_t remaining;
+} StealPass;
+
+// 64 boards of equal size packed side by side: bit i of every word is a cell
+// of board i. The planes are (height + 2) x (width + 2) words, cell (0, 0)
+// sits at index stride + 1 and the surrounding ring is the halo. The snapshot
+// holds the generation the boards are compared against for stabilization.
+typedef struct _SlicedBatch_
+{
+  size_t height;
+  size_t width;
+  size_t stride;
+  Topology topology;
+  uint64_t *current;
+  uint64_t *next;
+  uint64_t *snapshot;
+} SlicedBatch;
+
+typedef struct _EnsembleResult_
+{
+  size_t height;
+  size_t width;
+  size_t generations;
+  size_t population;
+  size_t period;
+  int failed;
+} EnsembleResult;
+
+typedef struct _Ensemble_
+{
+  Options *options;
+  char **paths;
+  size_t board_count;
+  EnsembleResult *results;
+  atomic_size_t next_board;
+  atomic_size_t board_generations;
+} Ensemble;
+
+typedef struct _Random_
+{
+  uint64_t state[4];
+} Random;
+
+// A horizontal run of live cells, from start up to but excluding end. The
+// runs of a board are joined into objects by a union-find over parent.
+typedef struct _CellRun_
+{
+  size_t row;
+  size_t start;
+  size_t end;
+  size_t parent;
+} CellRun;
+
+// An object is the set of runs sharing a root. Its runs are listed in
+// ObjectList.order from first_run on.
+typedef struct _BoardObject_
+{
+  size_t top;
+  size_t left;
+  size_t height;
+  size_t width;
+  size_t population;
+  size_t first_run;
+  size_t run_count;
+} BoardObject;
+
+// The objects of a board. All per run arrays share run_capacity, row_runs
+// holds the index of the first run of each row and one past the last.
+typedef struct _ObjectList_
+{
+  size_t height;
+  CellRun *runs;
+  size_t run_count;
+  size_t run_capacity;
+  size_t *row_runs;
+  size_t row_capacity;
+  size_t *order;
+  size_t *object_of;
+  uint8_t *merge;
+  BoardObject *objects;
+  size_t object_count;
+} ObjectList;
+
+// The live cells of an object cropped to its bounding box, row by row
+typedef struct _Shape_
+{
+  size_t height;
+  size_t width;
+  uint8_t *cells;
+} Shape;
+
+// What an object does when simulated on its own: the period after which it
+// reappears, the offset it moved by meanwhile and its apgcode, the canonical
+// name shared by all of its phases and orientations
+typedef struct _Classification_
+{
+  uint64_t hash;
+  Shape shape;
+  ObjectKind kind;
+  size_t period;
+  ptrdiff_t offset_y;
+  ptrdiff_t offset_x;
+  char *code;
+} Classification;
+
+// Open addressing table of classified shapes. The classifications are
+// allocated one by one, so they stay put while the table grows.
+typedef struct _ShapeCache_
+{
+  Classification **entries;
+  size_t capacity;
+  size_t count;
+} ShapeCache;
+
+typedef struct _CensusCount_
+{
+  const char *code;
+  uint64_t hash;
+  size_t count;
+} CensusCount;
+
+typedef struct _CensusTable_
+{
+  CensusCount *entries;
+  size_t capacity;
+  size_t count;
+} CensusTable;
+
+typedef struct _CensusWorker_
+{
+  ShapeCache cache;
+  CensusTable table;
+  ObjectList objects;
+  size_t stabilized;
+  size_t object_count;
+} CensusWorker;
+
+typedef struct _Census_
+{
+  Options *options;
+  CensusWorker *workers;
+  atomic_size_t next_soup;
+} Census;
+
+// A node of a macrocell quadtree. Leaves are 8x8 cells with bit 8 * row +
+// column of key[0] set for live cells, other nodes hold the indices of
+// their nw, ne, sw and se children in key. Index 0 is the empty node of
+// any level, the others count from 1 in the order the nodes are written.
+typedef struct _QuadNode_
+{
+  uint64_t key[4];
+  size_t level;
+  size_t index;
+} QuadNode;
+
+// Hash-consing table of quadtree nodes, an entry is empty while its index
+// is 0
+typedef struct _QuadTable_
+{
+  QuadNode *entries;
+  size_t capacity;
+  size_t count;
+} QuadTable;
+
+typedef struct _MacrocellWriter_
+{
+  Board *board;
+  FILE *output;
+  QuadTable table;
+} MacrocellWriter;
+
+// A node read from a macrocell file with the bounding box of its live cells
+// relative to its upper left corner
+typedef struct _MacrocellNode_
+{
+  uint64_t key[4];
+  size_t level;
+  uint64_t top;
+  uint64_t left;
+  uint64_t bottom;
+  uint64_t right;
+} MacrocellNode;
+
+// Blocks written to a compressed output are handed to a background thread
+// that deflates them in order. The writer fills block head % COMPRESS_BLOCKS
+// while the thread works through blocks tail to head - 1.
+typedef struct _CompressionQueue_
+{
+  gzFile file;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  char *blocks[COMPRESS_BLOCKS];
+  size_t sizes[COMPRESS_BLOCKS];
+  size_t head;
+  size_t tail;
+  size_t fill;
+  int closing;
+  atomic_int failed;
+} CompressionQueue;
+
+typedef enum _RecordFrameKind_
+{
+  RECORD_KEYFRAME,
+  RECORD_DELTA
+} RecordFrameKind;
+
+// A recording starts with the header and ends with the keyframe index. In
+// between every generation has a frame: the deflated bitmap of the board
+// for keyframes, the deflated varint gaps between the flipped cells for
+// deltas, padded to RECORD_ALIGNMENT. index_offset stays 0 until the
+// recording is closed.
+typedef struct _RecordHeader_
+{
+  char magic[8];
+  uint64_t height;
+  uint64_t width;
+  uint64_t keyframe_interval;
+  uint64_t first_generation;
+  uint64_t generation_count;
+  uint64_t keyframe_count;
+  uint64_t index_offset;
+} RecordHeader;
+
+typedef struct _RecordFrame_
+{
+  uint64_t generation;
+  uint64_t kind;
+  uint64_t cell_count;
+  uint64_t raw_size;
+  uint64_t compressed_size;
+} RecordFrame;
+
+typedef struct _RecordKey_
+{
+  uint64_t generation;
+  uint64_t offset;
+} RecordKey;
+
+// The simulation copies each generation into slot head % RECORD_SLOTS, the
+// recording thread packs, diffs, deflates and writes slots tail to head - 1.
+// Everything below the slots belongs to the recording thread.
+typedef struct _Recorder_
+{
+  FILE *output;
+  const char *path;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  size_t height;
+  size_t width;
+  size_t stride;
+  uint8_t *slots[RECORD_SLOTS];
+  size_t generations[RECORD_SLOTS];
+  size_t head;
+  size_t tail;
+  int closing;
+  int failed;
+  size_t row_words;
+  uint64_t *packed;
+  uint64_t *previous;
+  uint8_t *raw;
+  size_t raw_capacity;
+  uint8_t *compressed;
+  size_t compressed_capacity;
+  RecordKey *keys;
+  size_t key_count;
+  size_t key_capacity;
+  RecordHeader header;
+  uint64_t offset;
+} Recorder;
+
+// A recording mapped for replay. The board shows generation, which lies in
+// the span of keyframe span_key; span holds the offsets of the frames from
+// the keyframe up to that generation, so stepping back within the span
+// flips the same cells again.
+typedef struct _Replay_
+{
+  const uint8_t *data;
+  size_t size;
+  const RecordHeader *header;
+  const RecordKey *keys;
+  uint8_t *raw;
+  size_t raw_capacity;
+  uint64_t *span;
+  size_t span_key;
+  uint64_t generation;
+} Replay;
+
+// The last generations of an interactive run as the cells that flipped,
+// encoded like the deltas of a recording. deltas is a ring of capacity
+// entries from first to first + count - 1, the newest undoing the step to
+// the current generation. previous holds the packed current generation.
+typedef struct _HistoryDelta_
+{
+  uint8_t *gaps;
+  size_t size;
+} HistoryDelta;
+
+typedef struct _History_
+{
+  size_t height;
+  size_t width;
+  size_t row_words;
+  uint64_t *packed;
+  uint64_t *previous;
+  HistoryDelta *deltas;
+  size_t capacity;
+  size_t first;
+  size_t count;
+  size_t bytes;
+  size_t budget;
+  uint8_t *scratch;
+  size_t scratch_capacity;
+} History;
+
+// The keyboard of an interactive run, the standard input or, when that
+// holds the board, the controlling terminal. The settings are restored on
+// exit, however the run ends.
+typedef struct _Terminal_
+{
+  int input;
+  int owned;
+  int raw;
+  struct termios saved;
+} Terminal;
+
+// The window of the board shown on the terminal. Each character holds the
+// dots of its render mode, each dot stands for zoom x zoom cells from row
+// top and column left on, at most rows x columns characters fit between
+// the borders.
+typedef struct _Viewport_
+{
+  size_t top;
+  size_t left;
+  size_t zoom;
+  size_t rows;
+  size_t columns;
+  RenderMode mode;
+} Viewport;
+
+typedef struct _Analysis_
+{
+  ObjectList *list;
+  ShapeCache *caches;
+  const Classification **classifications;
+} Analysis;
+
+typedef struct _RandomFill_
+{
+  Board *board;
+  double density;
+  uint64_t seed;
+} RandomFill;
+
+typedef struct _Workload_
+{
+  const char *name;
+  WorkloadKind kind;
+  size_t height;
+  size_t width;
+  double density;
+  const char *source;
+  const char * const *pattern;
+  size_t generations;
+} Workload;
+
+// Each worker thread has its own counter per event. An event is either open on
+// every counted thread or on none, so fd[0] tells whether it is available.
+typedef struct _CheckTrial_
+{
+  const char *engine_name;
+  size_t trial;
+  double density;
+  uint64_t seed;
+} CheckTrial;
+
+typedef struct _PerfCounters_
+{
+  const char *name;
+  size_t threads;
+  int fd[MAX_WORKERS][PERF_EVENT_COUNT];
+  uint64_t value[PERF_EVENT_COUNT];
+  double seconds;
+  size_t calls;
+  size_t cells;
+  struct timespec start;
+} PerfCounters;
+
+//================
+/// GLOBALS
+//================
+static volatile sig_atomic_t keep_running = 1;
+static HugePageMode huge_page_mode = HUGE_PAGES_THP;
+static int numa_aware = 0;
+static int verbose = 1;
+static int background_compression = 0;
+static Terminal terminal = { .input = -1 };
+static volatile sig_atomic_t terminal_resized = 1;
+static size_t block_generations = BLOCK_DEFAULT_GENERATIONS;
+static WorkerPool worker_pool = { .size = 1 };
+
+void updateBoard(Board *board);
+void updateBoardRows(Board *board);
+void updateBoardParallel(Board *board);
+void updateBoardBlocked(Board *board);
+void advanceBoardBlocked(Board *board, size_t generations);
+void updateBoardPipelined(Board *board);
+void advanceBoardPipelined(Board *board, size_t generations);
+void updateBoardStealing(Board *board);
+void advanceBoardStealing(Board *board, size_t generations);
+
+static const Engine ENGINES[] =
+{
+  { "reference", updateBoard, NULL },
+  { "rowsum", updateBoardRows, NULL },
+  { "parallel", updateBoardParallel, NULL },
+  { "blocked", updateBoardBlocked, advanceBoardBlocked },
+  { "pipelined", updateBoardPipelined, advanceBoardPipelined },
+  { "stealing", updateBoardStealing, advanceBoardStealing }
+};
+#define ENGINE_COUNT (sizeof(ENGINES) / sizeof(ENGINES[0]))
+
+static const char * const GOSPER_GLIDER_GUN[] =
+{
+  "........................#...........",
+  "......................#.#...........",
+  "............##......##............##",
+  "...........#...#....##............##",
+  "##........#.....#...##..............",
+  "##........#...#.##....#.#...........",
+  "..........#.....#.......#...........",
+  "...........#...#....................",
+  "............##......................",
+  NULL
+};
+
+static const char * const R_PENTOMINO[] = { ".##", "##.", ".#.", NULL };
+static const char * const ACORN[] = { ".#.....", "...#...", "##..###", NULL };
+static const char * const DIEHARD[] = { "......#.", "##......", ".#...###", NULL };
+
+// Widths around the word size catch the edge cases of packed engines
+static const size_t CHECK_WIDTHS[] = { 1, 2, 3, 7, 31, 63, 64, 65, 127, 128, 129, 191, 257, 521 };
+#define CHECK_WIDTH_COUNT (sizeof(CHECK_WIDTHS) / sizeof(CHECK_WIDTHS[0]))
+
+// The benchmark suite is fixed so results stay comparable across versions
+static const Workload WORKLOADS[] =
+{
+  { "soup-64-d35", WORKLOAD_SOUP, 64, 64, 0.35, NULL, NULL, 2000 },
+  { "soup-256-d10", WORKLOAD_SOUP, 256, 256, 0.10, NULL, NULL, 500 },
+  { "soup-256-d35", WORKLOAD_SOUP, 256, 256, 0.35, NULL, NULL, 500 },
+  { "soup-256-d50", WORKLOAD_SOUP, 256, 256, 0.50, NULL, NULL, 500 },
+  { "soup-1024-d35", WORKLOAD_SOUP, 1024, 1024, 0.35, NULL, NULL, 50 },
+  { "soup-4096-d35", WORKLOAD_SOUP, 4096, 4096, 0.35, NULL, NULL, 5 },
+  { "soup-32768-d35", WORKLOAD_SOUP, 32768, 32768, 0.35, NULL, NULL, 1 },
+  { "pulsar-tiled-1024", WORKLOAD_TILES, 1024, 1024, 0.0, "config/pulsar.txt", NULL, 50 },
+  { "penta-tiled-1024", WORKLOAD_TILES, 1024, 1024, 0.0, "config/penta.txt", NULL, 50 },
+  { "pulsar-tiled-8192", WORKLOAD_TILES, 8192, 8192, 0.0, "config/pulsar.txt", NULL, 2 },
+  { "gosper-gun-256", WORKLOAD_PATTERN, 256, 256, 0.0, NULL, GOSPER_GLIDER_GUN, 1000 },
+  { "r-pentomino-512", WORKLOAD_PATTERN, 512, 512, 0.0, NULL, R_PENTOMINO, 1000 },
+  { "acorn-512", WORKLOAD_PATTERN, 512, 512, 0.0, NULL, ACORN, 1000 },
+  { "diehard-128", WORKLOAD_PATTERN, 128, 128, 0.0, NULL, DIEHARD, 130 }
+};
+#define WORKLOAD_COUNT (sizeof(WORKLOADS) / sizeof(WORKLOADS[0]))
+
+static const char * const SHADES[] = { "·", "░", "▒", "▓", "█" };
+static const char * const RENDER_MODE_NAMES[] = { "cells", "half", "braille" };
+static const size_t RENDER_DOT_WIDTH[] = { 1, 1, 2 };
+static const size_t RENDER_DOT_HEIGHT[] = { 1, 2, 4 };
+
+// Upper and lower cell of a character, the upper one in bit 0
+static const char * const HALF_BLOCKS[] = { " ", "▀", "▄", "█" };
+
+// Braille dots of the left and right cell of each of the four rows, the
+// pattern is added to U+2800
+static const uint8_t BRAILLE_DOTS[4][4] =
+{
+  { 0x00, 0x01, 0x08, 0x09 },
+  { 0x00, 0x02, 0x10, 0x12 },
+  { 0x00, 0x04, 0x20, 0x24 },
+  { 0x00, 0x40, 0x80, 0xc0 }
+};
+
+static const char * const OBJECT_KIND_NAMES[] = { "unknown", "still_life", "oscillator", "spaceship" };
+
+static const uint64_t PERF_EVENT_CONFIG[PERF_EVENT_COUNT] =
+{
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_REFERENCES,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+  PERF_COUNT_HW_BRANCH_MISSES
+};
+
+
+//------------------------------------------------------------------------------
+///
+/// Checks if the command line parameters are correct.
+///
+/// @param argc - the argument count
+/// @param argv - a list of command strings
+/// @param options - the parsed options
+///
+/// @return 0 if parameters are valid, otherwise a value > 1
+//
+int checkParams(int argc, char *argv[], Options *options)
+{
+  for (int arg = 1; arg < argc; arg++)
+  {
+    if (!strcmp(argv[arg], "-f") && arg + 1 < argc && options->file_path == NULL)
+    {
+      arg++;
+      printf("-> Using configuration file: %s\n", argv[arg]);
+      options->file_path = (char*) calloc(sizeof(char), strlen(argv[arg]) + 1);
+      if (options->file_path == NULL)
+      {
+        return ERROR;
+      }
+      strcpy(options->file_path, argv[arg]);
+    }
+    else if (!strcmp(argv[arg], "--perf-counters"))
+    {
+      options->perf_counters = 1;
+    }
+    else if (!strcmp(argv[arg], "--engine") && arg + 1 < argc)
+    {
+      arg++;
+      options->engine = NULL;
+      for (size_t engine = 0; engine < ENGINE_COUNT; engine++)
+      {
+        if (!strcmp(argv[arg], ENGINES[engine].name))
+        {
+          options->engine = &ENGINES[engine];
+        }
+      }
+      if (options->engine == NULL)
+      {
+        printf(ERROR_NO_ENGINE, argv[arg]);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--bench") && arg + 1 < argc)
+    {
+      options->bench_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--bench-max-size") && arg + 1 < argc)
+    {
+      options->bench_max_size = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--check") && arg + 1 < argc)
+    {
+      options->check_trials = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--seed") && arg + 1 < argc)
+    {
+      options->seed = strtoull(argv[++arg], NULL, 0);
+    }
+    else if (!strcmp(argv[arg], "--huge-pages") && arg + 1 < argc)
+    {
+      arg++;
+      if (!strcmp(argv[arg], "off"))
+      {
+        huge_page_mode = HUGE_PAGES_OFF;
+      }
+      else if (!strcmp(argv[arg], "thp"))
+      {
+        huge_page_mode = HUGE_PAGES_THP;
+      }
+      else if (!strcmp(argv[arg], "hugetlb"))
+      {
+        huge_page_mode = HUGE_PAGES_HUGETLB;
+      }
+      else
+      {
+        printf(USAGE_PROMPT);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--threads") && arg + 1 < argc)
+    {
+      options->threads = strtoull(argv[++arg], NULL, 10);
+      if (options->threads == 0 || options->threads > MAX_WORKERS)
+      {
+        printf("-> Error: Thread count must be between 1 and %d!\n", MAX_WORKERS);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--block-generations") && arg + 1 < argc)
+    {
+      block_generations = strtoull(argv[++arg], NULL, 10);
+      if (block_generations == 0 || block_generations > BLOCK_MAX_GENERATIONS)
+      {
+        printf("-> Error: Block generations must be between 1 and %d!\n", BLOCK_MAX_GENERATIONS);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--numa"))
+    {
+      numa_aware = 1;
+    }
+    else if (!strcmp(argv[arg], "--ensemble") && arg + 1 < argc)
+    {
+      options->ensemble_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--soups") && arg + 1 < argc)
+    {
+      options->soup_count = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--generations") && arg + 1 < argc)
+    {
+      options->generations = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--output") && arg + 1 < argc)
+    {
+      options->output_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--record") && arg + 1 < argc)
+    {
+      options->record_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--keyframe-interval") && arg + 1 < argc)
+    {
+      options->keyframe_interval = strtoull(argv[++arg], NULL, 10);
+      if (options->keyframe_interval == 0)
+      {
+        printf(USAGE_PROMPT);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--replay") && arg + 1 < argc)
+    {
+      options->replay_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--seek") && arg + 1 < argc)
+    {
+      options->seek_generation = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--replay-step") && arg + 1 < argc)
+    {
+      options->replay_step = strtoll(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--render") && arg + 1 < argc)
+    {
+      arg++;
+      for (options->render_mode = 0; options->render_mode < RENDER_MODE_COUNT &&
+           strcmp(argv[arg], RENDER_MODE_NAMES[options->render_mode]); options->render_mode++);
+      if (options->render_mode == RENDER_MODE_COUNT)
+      {
+        printf(USAGE_PROMPT);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--history-budget") && arg + 1 < argc)
+    {
+      options->history_budget = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--analyze") && arg + 1 < argc)
+    {
+      options->analyze_path = argv[++arg];
+    }
+    else if (!strcmp(argv[arg], "--census") && arg + 1 < argc)
+    {
+      options->census_soups = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--soup-size") && arg + 1 < argc)
+    {
+      if (sscanf(argv[++arg], "%zux%zu", &options->soup_width, &options->soup_height) != 2 ||
+          options->soup_width == 0 || options->soup_height == 0)
+      {
+        printf(USAGE_PROMPT);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--random") && arg + 1 < argc)
+    {
+      if (sscanf(argv[++arg], "%zux%zu", &options->random_width, &options->random_height) != 2 ||
+          options->random_width == 0 || options->random_height == 0)
+      {
+        printf(USAGE_PROMPT);
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--density") && arg + 1 < argc)
+    {
+      char *end;
+
+      options->density = strtod(argv[++arg], &end);
+      // Written as a negated range so NaN is rejected too
+      if (*end != '\0' || end == argv[arg] || !(options->density >= 0.0 && options->density <= 1.0))
+      {
+        printf("-> Error: Density must be between 0 and 1!\n");
+        return ERROR;
+      }
+    }
+    else if (!strcmp(argv[arg], "--max-generations") && arg + 1 < argc)
+    {
+      options->max_generations = strtoull(argv[++arg], NULL, 10);
+    }
+    else if (!strcmp(argv[arg], "--background-compress"))
+    {
+      background_compression = 1;
+    }
+    else if (!strcmp(argv[arg], "--torus"))
+    {
+      options->topology = TOPOLOGY_TORUS;
+    }
+    else
+    {
+      printf(USAGE_PROMPT);
+      return ERROR;
+    }
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads decompressed bytes of a gzip stream opened with openInput.
+///
+/// @param cookie - the gzFile
+/// @param buffer - receives the bytes
+/// @param size - the size of the buffer
+///
+/// @return the number of bytes read, 0 at the end, -1 on errors
+//
+ssize_t readGzip(void *cookie, char *buffer, size_t size)
+{
+  int count = gzread((gzFile) cookie, buffer, (size > INT32_MAX) ? INT32_MAX : (unsigned) size);
+
+  return (count < 0) ? -1 : count;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Seeks in the decompressed bytes of a gzip stream, going back means
+/// decompressing again from the start.
+///
+/// @param cookie - the gzFile
+/// @param offset - the offset, receives the new position
+/// @param whence - SEEK_SET or SEEK_CUR
+///
+/// @return 0 on success, otherwise -1
+//
+int seekGzip(void *cookie, off64_t *offset, int whence)
+{
+  z_off_t position = gzseek((gzFile) cookie, (z_off_t) *offset, whence);
+
+  if (position < 0)
+  {
+    return -1;
+  }
+  *offset = position;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Compresses bytes into a gzip stream opened with openOutput.
+///
+/// @param cookie - the gzFile
+/// @param buffer - the bytes
+/// @param size - the number of bytes
+///
+/// @return the number of bytes written, 0 on errors
+//
+ssize_t writeGzip(void *cookie, const char *buffer, size_t size)
+{
+  size_t written = 0;
+
+  while (written < size)
+  {
+    unsigned chunk = (size - written > INT32_MAX) ? INT32_MAX : (unsigned) (size - written);
+    int count = gzwrite((gzFile) cookie, buffer + written, chunk);
+    if (count <= 0)
+    {
+      return 0;
+    }
+    written += (size_t) count;
+  }
+  return (ssize_t) written;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Closes a gzip stream.
+///
+/// @param cookie - the gzFile
+///
+/// @return 0 on success, otherwise -1
+//
+int closeGzip(void *cookie)
+{
+  return (gzclose((gzFile) cookie) == Z_OK) ? 0 : -1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Background thread of a compressed output, deflating the handed over
+/// blocks in order until the output is closed.
+///
+/// @param argument - the CompressionQueue
+///
+/// @return NULL
+//
+void *runCompression(void *argument)
+{
+  CompressionQueue *queue = (CompressionQueue*) argument;
+
+  pthread_mutex_lock(&queue->lock);
+  while (1)
+  {
+    size_t block;
+
+    while (queue->tail == queue->head && !queue->closing)
+    {
+      pthread_cond_wait(&queue->changed, &queue->lock);
+    }
+    if (queue->tail == queue->head)
+    {
+      break;
+    }
+    block = queue->tail % COMPRESS_BLOCKS;
+    pthread_mutex_unlock(&queue->lock);
+
+    if (writeGzip(queue->file, queue->blocks[block], queue->sizes[block]) != (ssize_t) queue->sizes[block])
+    {
+      // Read by the writer without the lock
+      atomic_store(&queue->failed, 1);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    queue->tail++;
+    pthread_cond_broadcast(&queue->changed);
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies bytes into the blocks of a compressed output, handing every full
+/// block to the background thread. Waits while all blocks are in use.
+///
+/// @param cookie - the CompressionQueue
+/// @param buffer - the bytes
+/// @param size - the number of bytes
+///
+/// @return the number of bytes written, 0 on errors
+//
+ssize_t writeQueued(void *cookie, const char *buffer, size_t size)
+{
+  CompressionQueue *queue = (CompressionQueue*) cookie;
+  size_t written = 0;
+
+  while (written < size && !atomic_load(&queue->failed))
+  {
+    size_t chunk = COMPRESS_BLOCK_SIZE - queue->fill;
+
+    chunk = (chunk < size - written) ? chunk : size - written;
+    memcpy(queue->blocks[queue->head % COMPRESS_BLOCKS] + queue->fill, buffer + written, chunk);
+    queue->fill += chunk;
+    written += chunk;
+    if (queue->fill == COMPRESS_BLOCK_SIZE)
+    {
+      pthread_mutex_lock(&queue->lock);
+      queue->sizes[queue->head % COMPRESS_BLOCKS] = queue->fill;
+      queue->head++;
+      pthread_cond_broadcast(&queue->changed);
+      while (queue->head - queue->tail == COMPRESS_BLOCKS)
+      {
+        pthread_cond_wait(&queue->changed, &queue->lock);
+      }
+      pthread_mutex_unlock(&queue->lock);
+      queue->fill = 0;
+    }
+  }
+  return atomic_load(&queue->failed) ? 0 : (ssize_t) written;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Hands the last block of a compressed output to the background thread,
+/// waits for it to finish and closes the stream.
+///
+/// @param cookie - the CompressionQueue
+///
+/// @return 0 on success, otherwise -1
+//
+int closeQueued(void *cookie)
+{
+  CompressionQueue *queue = (CompressionQueue*) cookie;
+  int failed;
+
+  pthread_mutex_lock(&queue->lock);
+  if (queue->fill > 0)
+  {
+    queue->sizes[queue->head % COMPRESS_BLOCKS] = queue->fill;
+    queue->head++;
+  }
+  queue->closing = 1;
+  pthread_cond_broadcast(&queue->changed);
+  pthread_mutex_unlock(&queue->lock);
+  pthread_join(queue->thread, NULL);
+
+  failed = atomic_load(&queue->failed) | (gzclose(queue->file) != Z_OK);
+  pthread_mutex_destroy(&queue->lock);
+  pthread_cond_destroy(&queue->changed);
+  free(queue->blocks[0]);
+  free(queue);
+  return failed ? -1 : 0;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Opens a file for reading, "-" for the standard input. Files starting
+/// with the gzip magic bytes are decompressed on the fly while they are read.
+///
+/// @param file_path - path of the file
+///
+/// @return the stream or NULL on failure
+//
+FILE *openInput(const char *file_path)
+{
+  cookie_io_functions_t functions = { readGzip, NULL, seekGzip, closeGzip };
+  gzFile compressed;
+  FILE *stream;
+
+  if (!strcmp(file_path, "-"))
+  {
+    // Pipes cannot be peeked at, zlib passes bytes without the magic through
+    int descriptor = dup(STDIN_FILENO);
+
+    compressed = (descriptor < 0) ? NULL : gzdopen(descriptor, "rb");
+    if (compressed == NULL)
+    {
+      if (descriptor >= 0)
+      {
+        close(descriptor);
+      }
+      return NULL;
+    }
+  }
+  else
+  {
+    FILE *file = fopen(file_path, "rb");
+    char magic[2];
+
+    if (file == NULL || fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        memcmp(magic, GZIP_MAGIC, sizeof(magic)))
+    {
+      if (file != NULL)
+      {
+        rewind(file);
+      }
+      return file;
+    }
+    fclose(file);
+
+    compressed = gzopen(file_path, "rb");
+    if (compressed == NULL)
+    {
+      return NULL;
+    }
+  }
+  gzbuffer(compressed, READ_CHUNK_SIZE);
+  stream = fopencookie(compressed, "rb", functions);
+  if (stream == NULL)
+  {
+    gzclose(compressed);
+  }
+  return stream;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a whole file into a growable buffer in one pass, without seeking.
+///
+/// @param file - the open file
+/// @param buffer - receives the allocated contents, terminated by '\0'
+/// @param size - receives the size of the contents
+///
+/// @return 0 if the file could be read, otherwise a value > 1
+//
+int readWholeFile(FILE *file, char **buffer, size_t *size)
+{
+  size_t capacity = READ_CHUNK_SIZE;
+  size_t length = 0;
+  size_t count;
+
+  *buffer = (char*) malloc(capacity + 1);
+  if (*buffer == NULL)
+  {
+    return ERROR;
+  }
+  while ((count = fread(*buffer + length, 1, capacity - length, file)) > 0)
+  {
+    length += count;
+    if (length == capacity)
+    {
+      char *grown = (char*) realloc(*buffer, 2 * capacity + 1);
+      if (grown == NULL)
+      {
+        free(*buffer);
+        *buffer = NULL;
+        return ERROR;
+      }
+      *buffer = grown;
+      capacity *= 2;
+    }
+  }
+  if (ferror(file))
+  {
+    free(*buffer);
+    *buffer = NULL;
+    return ERROR;
+  }
+  (*buffer)[length] = '\0';
+  *size = length;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a whole input file, "-" for the standard input, in a single pass.
+/// Works for pipes and other streams that cannot seek.
+///
+/// @param file_path - path of the file
+/// @param contents - receives the allocated contents, terminated by '\0'
+/// @param size - receives the size of the contents
+///
+/// @return 0 if the file could be read, otherwise a value > 1
+//
+int readInput(const char *file_path, char **contents, size_t *size)
+{
+  FILE *input = openInput(file_path);
+  int result;
+
+  if (input == NULL)
+  {
+    printf(ERROR_NO_FILE, file_path);
+    return ERROR;
+  }
+  result = readWholeFile(input, contents, size);
+  fclose(input);
+  if (result != OK)
+  {
+    printf("-> Error: Could not read \"%s\"!\n", file_path);
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Opens a file for writing. Paths ending in ".gz" are gzip compressed,
+/// with --background-compress on a thread of their own, so formatting and
+/// deflating overlap.
+///
+/// @param file_path - path of the file
+///
+/// @return the stream or NULL on failure
+//
+FILE *openOutput(const char *file_path)
+{
+  size_t length = strlen(file_path);
+  gzFile compressed;
+  FILE *stream;
+
+  if (length < 3 || strcmp(file_path + length - 3, ".gz"))
+  {
+    return fopen(file_path, "wb");
+  }
+  compressed = gzopen(file_path, "wb6");
+  if (compressed == NULL)
+  {
+    return NULL;
+  }
+  gzbuffer(compressed, READ_CHUNK_SIZE);
+
+  if (background_compression)
+  {
+    cookie_io_functions_t functions = { NULL, writeQueued, NULL, closeQueued };
+    CompressionQueue *queue = (CompressionQueue*) calloc(1, sizeof(CompressionQueue));
+    char *blocks = (char*) malloc((size_t) COMPRESS_BLOCKS * COMPRESS_BLOCK_SIZE);
+
+    if (queue == NULL || blocks == NULL)
+    {
+      free(queue);
+      free(blocks);
+      gzclose(compressed);
+      return NULL;
+    }
+    queue->file = compressed;
+    atomic_init(&queue->failed, 0);
+    for (size_t block = 0; block < COMPRESS_BLOCKS; block++)
+    {
+      queue->blocks[block] = blocks + block * COMPRESS_BLOCK_SIZE;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->changed, NULL);
+    if (pthread_create(&queue->thread, NULL, runCompression, queue) == 0)
+    {
+      stream = fopencookie(queue, "wb", functions);
+      if (stream != NULL)
+      {
+        return stream;
+      }
+      closeQueued(queue);
+      return NULL;
+    }
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->changed);
+    free(queue);
+    free(blocks);
+  }
+
+  cookie_io_functions_t functions = { NULL, writeGzip, NULL, closeGzip };
+  stream = fopencookie(compressed, "wb", functions);
+  if (stream == NULL)
+  {
+    gzclose(compressed);
+  }
+  return stream;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Checks whether a path ends with the given extension, optionally followed
+/// by ".gz".
+///
+/// @param file_path - the path
+/// @param extension - the extension including the dot
+///
+/// @return 1 if it does, otherwise 0
+//
+int hasExtension(const char *file_path, const char *extension)
+{
+  size_t length = strlen(file_path);
+  size_t extension_length = strlen(extension);
+
+  if (length >= 3 && !strcmp(file_path + length - 3, ".gz"))
+  {
+    length -= 3;
+  }
+  return length >= extension_length && !strncmp(file_path + length - extension_length, extension, extension_length);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Checks if the contents of the config file are valid. A newline after the
+/// last row is optional.
+///
+/// @param contents - the contents of the config file
+/// @param size - the size of the contents
+/// @param board_height - pointer to the height of the board
+/// @param board_width - pointer to the width of the board
+///
+/// @return 0 if file is valid, otherwise a value > 1
+//
+int checkConfigFile(const char *contents, size_t size, size_t *board_height, size_t *board_width)
+{
+  size_t last_column_count = SIZE_MAX;
+  size_t current_column_count = 0;
+  size_t row_count = 0;
+
+  if (size > 0 && contents[size - 1] == '\n')
+  {
+    size--;
+  }
+  for (size_t position = 0; position <= size; position++)
+  {
+    char current_char = (position < size) ? contents[position] : '\n';
+
+    if (current_char == '\n')
+    {
+      (last_column_count == SIZE_MAX) ? (last_column_count = current_column_count) : (last_column_count);
+      if (last_column_count != current_column_count || current_column_count == 0)
+      {
+        printf("-> Error: Inconsistent column count detected!\n");
+        return ERROR;
+      }
+      row_count++;
+      current_column_count = 0;
+    }
+    else if (current_char != '.' && current_char != '#')
+    {
+      printf("-> Error: Invalid char \"%c\" detected!\n", current_char);
+      return ERROR;
+    }
+    else
+    {
+      current_column_count++;
+    }
+  }
+
+  *board_width = last_column_count;
+  *board_height = row_count;
+
+  if (verbose)
+  {
+    printf("-> Info: Rows = %zu, Columns = %zu\n", *board_height, *board_width);
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Returns a row of one generation of the board. Rows -1 and height are the
+/// halo rows.
+///
+/// @param board - the board
+/// @param plane - board->current or board->next
+/// @param row - the row, may be -1
+///
+/// @return pointer to column 0 of the row
+//
+static inline uint8_t *boardRow(const Board *board, uint8_t *plane, ptrdiff_t row)
+{
+  return plane + row * (ptrdiff_t) board->stride;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Collects the CPUs this process may run on, ordered node by node so that
+/// consecutive workers share a NUMA node. Without NUMA information all CPUs
+/// count as node 0.
+///
+/// @param cpus - receives the ordered CPU numbers
+/// @param node_count - receives the number of nodes with usable CPUs
+///
+/// @return the number of CPUs found
+//
+size_t collectNumaCpus(int *cpus, size_t *node_count)
+{
+  cpu_set_t allowed;
+  size_t cpu_count = 0;
+  char path[64];
+
+  *node_count = 0;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed))
+  {
+    return 0;
+  }
+  for (size_t node = 0; node < MAX_WORKERS && cpu_count < MAX_WORKERS; node++)
+  {
+    FILE *cpulist;
+    int first;
+    int last;
+    size_t node_cpus = 0;
+
+    snprintf(path, sizeof(path), NUMA_NODE_PATH, node);
+    cpulist = fopen(path, "r");
+    if (cpulist == NULL)
+    {
+      if (node == 0)
+      {
+        break;
+      }
+      continue;
+    }
+    // The list looks like "0-3,8-11"
+    while (fscanf(cpulist, "%d", &first) == 1)
+    {
+      if (fscanf(cpulist, "-%d", &last) != 1)
+      {
+        last = first;
+      }
+      for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE && cpu_count < MAX_WORKERS; cpu++)
+      {
+        if (CPU_ISSET(cpu, &allowed))
+        {
+          cpus[cpu_count++] = cpu;
+          node_cpus++;
+        }
+      }
+      if (fgetc(cpulist) != ',')
+      {
+        break;
+      }
+    }
+    fclose(cpulist);
+    *node_count += (node_cpus > 0);
+  }
+
+  if (cpu_count == 0)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE && cpu_count < MAX_WORKERS; cpu++)
+    {
+      if (CPU_ISSET(cpu, &allowed))
+      {
+        cpus[cpu_count++] = cpu;
+      }
+    }
+    *node_count = 1;
+  }
+  return cpu_count;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Pins the calling thread to a single CPU.
+///
+/// @param cpu - the CPU, negative values leave the thread unpinned
+//
+void pinThread(int cpu)
+{
+  cpu_set_t set;
+
+  if (cpu < 0)
+  {
+    return;
+  }
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Main loop of a pool thread, runs every handed out job until the pool is
+/// stopped.
+///
+/// @param argument - the worker index
+///
+/// @return always NULL
+//
+void *runWorker(void *argument)
+{
+  size_t worker = (size_t) (uintptr_t) argument;
+
+  pinThread(worker_pool.cpus[worker]);
+  while (1)
+  {
+    pthread_barrier_wait(&worker_pool.start);
+    if (worker_pool.stopping)
+    {
+      break;
+    }
+    worker_pool.job(worker_pool.argument, worker);
+    pthread_barrier_wait(&worker_pool.done);
+  }
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs a job on every worker of the pool and waits until all are done.
+///
+/// @param job - the job, called with the argument and the worker index
+/// @param argument - passed through to the job
+//
+void runWorkers(void (*job)(void *argument, size_t worker), void *argument)
+{
+  if (worker_pool.size <= 1)
+  {
+    job(argument, 0);
+    return;
+  }
+  worker_pool.job = job;
+  worker_pool.argument = argument;
+  pthread_barrier_wait(&worker_pool.start);
+  job(argument, 0);
+  pthread_barrier_wait(&worker_pool.done);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Notes the kernel thread id of a worker, so per-thread hardware counters
+/// can be opened for it from the calling thread.
+///
+/// @param argument - unused
+/// @param worker - the worker index
+//
+void noteWorkerThread(void *argument, size_t worker)
+{
+  (void) argument;
+  worker_pool.thread_ids[worker] = (pid_t) syscall(SYS_gettid);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Stops and joins the pool threads.
+//
+void stopWorkerPool(void)
+{
+  if (worker_pool.size <= 1)
+  {
+    return;
+  }
+  worker_pool.stopping = 1;
+  pthread_barrier_wait(&worker_pool.start);
+  for (size_t worker = 1; worker < worker_pool.size; worker++)
+  {
+    pthread_join(worker_pool.threads[worker], NULL);
+  }
+  pthread_barrier_destroy(&worker_pool.start);
+  pthread_barrier_destroy(&worker_pool.done);
+  worker_pool.size = 1;
+  worker_pool.stopping = 0;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Starts the worker pool. With --numa the workers (including the calling
+/// thread) are pinned to CPUs in node order, so the contiguous row bands of
+/// one node are owned by workers of that node.
+///
+/// @param size - the number of workers including the calling thread
+///
+/// @return 0 if the pool is running, otherwise a value > 1
+//
+int startWorkerPool(size_t size)
+{
+  int cpus[MAX_WORKERS];
+  size_t cpu_count = 0;
+
+  worker_pool.size = size;
+  worker_pool.node_count = 1;
+  for (size_t worker = 0; worker < size; worker++)
+  {
+    worker_pool.cpus[worker] = -1;
+  }
+  if (numa_aware)
+  {
+    cpu_count = collectNumaCpus(cpus, &worker_pool.node_count);
+    for (size_t worker = 0; worker < size && cpu_count > 0; worker++)
+    {
+      worker_pool.cpus[worker] = cpus[worker % cpu_count];
+    }
+    printf("-> Info: %zu workers pinned across %zu NUMA nodes\n", size, worker_pool.node_count);
+  }
+  pinThread(worker_pool.cpus[0]);
+  worker_pool.thread_ids[0] = (pid_t) syscall(SYS_gettid);
+  if (size <= 1)
+  {
+    return OK;
+  }
+
+  pthread_barrier_init(&worker_pool.start, NULL, size);
+  pthread_barrier_init(&worker_pool.done, NULL, size);
+  for (size_t worker = 1; worker < size; worker++)
+  {
+    if (pthread_create(&worker_pool.threads[worker], NULL, runWorker, (void*) (uintptr_t) worker))
+    {
+      printf("-> Error: Could not start worker thread %zu!\n", worker);
+      // The started workers wait on barriers sized for the full pool, so
+      // they are released by an abort of the process only
+      return ERROR;
+    }
+  }
+  runWorkers(noteWorkerThread, NULL);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Splits the rows of a board into one contiguous band per worker.
+///
+/// @param board_height - the height of the board
+/// @param worker - the worker index
+/// @param first_row - receives the first row of the band
+/// @param last_row - receives one past the last row of the band
+//
+void bandRows(size_t board_height, size_t worker, size_t *first_row, size_t *last_row)
+{
+  *first_row = board_height * worker / worker_pool.size;
+  *last_row = board_height * (worker + 1) / worker_pool.size;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Allocates the memory of a board arena. Arenas beyond HUGE_PAGE_THRESHOLD
+/// are mapped directly, aligned to HUGE_PAGE_SIZE and backed by huge pages
+/// as selected with --huge-pages: explicit hugetlbfs pages fall back to
+/// transparent huge pages if none are reserved. Mapped arenas are already
+/// zeroed by the kernel.
+///
+/// @param size - the size of the arena, a multiple of BOARD_ALIGNMENT
+/// @param backing - how the arena was obtained
+///
+/// @return the zeroed arena or NULL on failure
+//
+uint8_t *allocateArena(size_t size, ArenaBacking *backing)
+{
+  uint8_t *arena;
+
+  if (huge_page_mode == HUGE_PAGES_OFF || size < HUGE_PAGE_THRESHOLD)
+  {
+    *backing = ARENA_HEAP;
+    arena = (uint8_t*) aligned_alloc(BOARD_ALIGNMENT, size);
+    if (arena != NULL)
+    {
+      memset(arena, CELL_DEAD, size);
+    }
+    return arena;
+  }
+
+  size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (huge_page_mode == HUGE_PAGES_HUGETLB)
+  {
+    arena = (uint8_t*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (arena != MAP_FAILED)
+    {
+      *backing = ARENA_HUGETLB;
+      return arena;
+    }
+    printf("-> Info: No hugetlbfs pages available (%s), using transparent huge pages\n", strerror(errno));
+  }
+
+  // Over-map by one huge page so the arena can start on a huge page boundary
+  arena = (uint8_t*) mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arena == MAP_FAILED)
+  {
+    return NULL;
+  }
+  size_t head = (HUGE_PAGE_SIZE - (uintptr_t) arena % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+  if (head > 0)
+  {
+    munmap(arena, head);
+  }
+  munmap(arena + head + size, HUGE_PAGE_SIZE - head);
+  arena += head;
+  madvise(arena, size, MADV_HUGEPAGE);
+  *backing = ARENA_MMAP;
+  return arena;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job touching the band of rows (in both generations) the worker
+/// will later update, so the kernel places those pages on its NUMA node.
+///
+/// @param argument - the board
+/// @param worker - the worker index
+//
+void touchBand(void *argument, size_t worker)
+{
+  Board *board = (Board*) argument;
+  ptrdiff_t first_row;
+  ptrdiff_t last_row;
+  size_t first;
+  size_t last;
+
+  bandRows(board->height, worker, &first, &last);
+  // The halo rows belong to the first and last band
+  first_row = (first == 0) ? -1 : (ptrdiff_t) first;
+  last_row = (last == board->height) ? (ptrdiff_t) last + 1 : (ptrdiff_t) last;
+  if (last_row > first_row)
+  {
+    size_t size = (last_row - first_row) * board->stride;
+    memset(boardRow(board, board->current, first_row) - BOARD_ALIGNMENT, CELL_DEAD, size);
+    memset(boardRow(board, board->next, first_row) - BOARD_ALIGNMENT, CELL_DEAD, size);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Allocates an empty board where every cell is dead. The board is carved
+/// from a single aligned arena, see Board.
+///
+/// @param board - the allocated board
+/// @param board_height - the height of the board
+/// @param board_width - the width of the board
+///
+/// @return 0 if board could be allocated, otherwise a value > 1
+//
+int allocateBoard(Board **board, size_t board_height, size_t board_width)
+{
+  size_t header_size = (sizeof(Board) + BOARD_ALIGNMENT - 1) / BOARD_ALIGNMENT * BOARD_ALIGNMENT;
+  size_t stride = (BOARD_ALIGNMENT + board_width + 1 + BOARD_ALIGNMENT - 1) / BOARD_ALIGNMENT * BOARD_ALIGNMENT;
+  size_t tile_rows = (board_height + ACTIVITY_TILE_HEIGHT - 1) / ACTIVITY_TILE_HEIGHT;
+  size_t tile_columns = (board_width + ACTIVITY_TILE_WIDTH - 1) / ACTIVITY_TILE_WIDTH;
+  size_t activity_size = (2 * tile_rows * tile_columns + BOARD_ALIGNMENT - 1) / BOARD_ALIGNMENT * BOARD_ALIGNMENT;
+  size_t plane_size;
+  ArenaBacking backing;
+  uint8_t *arena;
+
+  *board = NULL;
+  if (board_height == 0 || board_width == 0 || board_width > SIZE_MAX / 4 ||
+      board_height > (SIZE_MAX / 4 - header_size) / stride - 2)
+  {
+    return ERROR;
+  }
+  plane_size = (board_height + 2) * stride;
+
+  arena = allocateArena(header_size + 2 * plane_size + activity_size, &backing);
+  if (arena == NULL)
+  {
+    return ERROR;
+  }
+
+  *board = (Board*) arena;
+  (*board)->height = board_height;
+  (*board)->width = board_width;
+  (*board)->stride = stride;
+  (*board)->topology = TOPOLOGY_BOUNDED;
+  (*board)->current = arena + header_size + stride + BOARD_ALIGNMENT;
+  (*board)->next = (*board)->current + plane_size;
+  (*board)->arena_size = header_size + 2 * plane_size + activity_size;
+  (*board)->backing = backing;
+  (*board)->generation = 0;
+  (*board)->tile_rows = tile_rows;
+  (*board)->tile_columns = tile_columns;
+  (*board)->changed = arena + header_size + 2 * plane_size;
+  (*board)->new_changed = (*board)->changed + tile_rows * tile_columns;
+  (*board)->activity_generation = SIZE_MAX;
+  (*board)->steal = NULL;
+
+  // Mapped arenas are still untouched, let every worker fault in its band
+  if (numa_aware && backing != ARENA_HEAP)
+  {
+    runWorkers(touchBand, *board);
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Releases a board allocated by allocateBoard.
+///
+/// @param board - the board to release, may be NULL
+//
+void freeBoard(Board *board)
+{
+  if (board == NULL)
+  {
+    return;
+  }
+  if (board->steal != NULL)
+  {
+    // The tasks of all deques are one block
+    free(board->steal->deques[0].tasks);
+    free(board->steal->deques);
+    free(board->steal->active_tiles);
+    free(board->steal);
+  }
+  if (board->backing == ARENA_HEAP)
+  {
+    free(board);
+  }
+  else
+  {
+    munmap(board, (board->arena_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Determines how much of the board arena is currently backed by huge pages.
+/// Transparent huge pages are only assigned once memory is touched, so this
+/// is meaningful after the board has been filled.
+///
+/// @param board - the board
+///
+/// @return the number of bytes on huge pages
+//
+size_t countHugePageBytes(const Board *board)
+{
+  uintptr_t arena_start = (uintptr_t) board;
+  uintptr_t arena_end = arena_start + board->arena_size;
+  uintptr_t vma_start = 0;
+  uintptr_t vma_end = 0;
+  size_t huge_bytes = 0;
+  char line[256];
+  FILE *smaps;
+
+  if (board->backing == ARENA_HUGETLB)
+  {
+    return board->arena_size;
+  }
+  smaps = fopen("/proc/self/smaps", "r");
+  if (smaps == NULL)
+  {
+    return 0;
+  }
+  while (fgets(line, sizeof(line), smaps) != NULL)
+  {
+    unsigned long long start;
+    unsigned long long end;
+    size_t kilobytes;
+
+    if (sscanf(line, "%llx-%llx ", &start, &end) == 2)
+    {
+      vma_start = (uintptr_t) start;
+      vma_end = (uintptr_t) end;
+    }
+    else if (sscanf(line, "AnonHugePages: %zu kB", &kilobytes) == 1 && vma_start < arena_end &&
+             vma_end > arena_start)
+    {
+      huge_bytes += kilobytes * 1024;
+    }
+  }
+  fclose(smaps);
+  return (huge_bytes > board->arena_size) ? board->arena_size : huge_bytes;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Resets the peak resident set size of the process to the current one, so
+/// the next readPeakRss covers only what ran in between. Kernels without
+/// clear_refs keep the peak over the lifetime of the process.
+//
+void resetPeakRss(void)
+{
+  FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+
+  if (clear_refs != NULL)
+  {
+    fputs("5", clear_refs);
+    fclose(clear_refs);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads the peak resident set size since the last resetPeakRss.
+///
+/// @return the peak in KiB
+//
+long readPeakRss(void)
+{
+  struct rusage usage;
+  char line[256];
+  long kilobytes = -1;
+  FILE *status = fopen("/proc/self/status", "r");
+
+  if (status != NULL)
+  {
+    while (kilobytes < 0 && fgets(line, sizeof(line), status) != NULL)
+    {
+      if (sscanf(line, "VmHWM: %ld kB", &kilobytes) != 1)
+      {
+        kilobytes = -1;
+      }
+    }
+    fclose(status);
+  }
+  if (kilobytes < 0)
+  {
+    getrusage(RUSAGE_SELF, &usage);
+    kilobytes = usage.ru_maxrss;
+  }
+  return kilobytes;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Brings the halo of the current generation up to date. Torus boards copy
+/// the opposite edges into it, bounded boards keep it dead.
+///
+/// @param board - the board
+//
+void refreshHalo(Board *board)
+{
+  ptrdiff_t height = (ptrdiff_t) board->height;
+  size_t width = board->width;
+
+  if (board->topology != TOPOLOGY_TORUS)
+  {
+    return;
+  }
+  for (ptrdiff_t row = 0; row < height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    cells[-1] = cells[width - 1];
+    cells[width] = cells[0];
+  }
+  memcpy(boardRow(board, board->current, -1) - 1, boardRow(board, board->current, height - 1) - 1, width + 2);
+  memcpy(boardRow(board, board->current, height) - 1, boardRow(board, board->current, 0) - 1, width + 2);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Makes the next generation the current one.
+///
+/// @param board - the board
+//
+void swapGenerations(Board *board)
+{
+  uint8_t *current = board->current;
+  board->current = board->next;
+  board->next = current;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Fills the board and checks if board is valid.
+///
+/// @param contents - the contents of the checked config file
+/// @param board - the allocated board
+/// @param board_height - the height of the board
+/// @param board_width - the width of the board
+///
+/// @return 0 if board is valid, otherwise a value > 1
+//
+int fillBoard(const char *contents, Board **board, size_t board_height, size_t board_width)
+{
+  if (allocateBoard(board, board_height, board_width))
+  {
+    return ERROR;
+  }
+
+  for (size_t row = 0; row < board_height; row++)
+  {
+    uint8_t *cells = boardRow(*board, (*board)->current, row);
+    const char *line = contents + row * (board_width + 1);
+    for (size_t column = 0; column < board_width; column++)
+    {
+      cells[column] = (line[column] == '#') ? CELL_ALIVE : CELL_DEAD;
+    }
+  }
+
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step
+///
+/// @param board - the board, its topology decides whether cells beyond the
+///                edges are dead or wrap around
+//
+void updateBoard(Board *board)
+{
+  Neighbour neighbour[8] = { {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1} };
+  size_t board_height = board->height;
+  size_t board_width = board->width;
+
+  for (size_t row = 0; row < board_height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    uint8_t *new_cells = boardRow(board, board->next, row);
+
+    for (size_t column = 0; column < board_width; column++)
+    {
+      size_t neighbour_count = 0;
+
+      // Checking all 8 neighbours
+      for (size_t count = 0; count < 8; count++)
+      {
+        size_t neighbour_row = row + neighbour[count].offset_y;
+        size_t neighbour_column = column + neighbour[count].offset_x;
+
+        if (board->topology == TOPOLOGY_TORUS)
+        {
+          neighbour_row = (row + board_height + neighbour[count].offset_y) % board_height;
+          neighbour_column = (column + board_width + neighbour[count].offset_x) % board_width;
+        }
+        else if (neighbour_row >= board_height || neighbour_column >= board_width)
+        {
+          continue;
+        }
+        if (boardRow(board, board->current, neighbour_row)[neighbour_column] == CELL_ALIVE)
+        {
+          neighbour_count++;
+        }
+      }
+      // We are on a live cell and we have two or three live neighbours = survive
+      if (cells[column] == CELL_ALIVE && (neighbour_count == 2 || neighbour_count == 3))
+      {
+        new_cells[column] = CELL_ALIVE;
+      }
+      // We are on a dead cell and we have exactly three neighbours = become alive
+      else if (cells[column] == CELL_DEAD && neighbour_count == 3)
+      {
+        new_cells[column] = CELL_ALIVE;
+      }
+      // Otherwise the cell dies/stays dead
+      else
+      {
+        new_cells[column] = CELL_DEAD;
+      }
+    }
+  }
+
+  // Persist values
+  swapGenerations(board);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Computes the next generation of one row from the row and its neighbours.
+/// The cells before column 0 and after the last column must be readable.
+///
+/// @param above - the row above
+/// @param cells - the row itself
+/// @param below - the row below
+/// @param new_cells - receives the next generation of the row
+/// @param width - the number of cells to compute
+//
+static inline void updateRow(const uint8_t *restrict above, const uint8_t *restrict cells,
+                             const uint8_t *restrict below, uint8_t *restrict new_cells, size_t width)
+{
+  for (size_t column = 0; column < width; column++)
+  {
+    uint8_t neighbour_count = above[column - 1] + above[column] + above[column + 1] + cells[column - 1] +
+                              cells[column + 1] + below[column - 1] + below[column] + below[column + 1];
+    new_cells[column] = (neighbour_count == 3) | ((neighbour_count == 2) & cells[column]);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Computes the next generation of a range of rows. Relies on the halo
+/// instead of bounds checks, so the inner loop is branch free and can be
+/// vectorized by the compiler.
+///
+/// @param board - the board with an up to date halo
+/// @param first_row - the first row to update
+/// @param last_row - one past the last row to update
+//
+void updateRowRange(const Board *board, size_t first_row, size_t last_row)
+{
+  for (size_t row = first_row; row < last_row; row++)
+  {
+    updateRow(boardRow(board, board->current, (ptrdiff_t) row - 1), boardRow(board, board->current, row),
+              boardRow(board, board->current, row + 1), boardRow(board, board->next, row), board->width);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step by summing the
+/// neighbourhood of whole rows at once.
+///
+/// @param board - the board
+//
+void updateBoardRows(Board *board)
+{
+  refreshHalo(board);
+  updateRowRange(board, 0, board->height);
+  swapGenerations(board);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job updating the band of rows owned by the worker.
+///
+/// @param argument - the board
+/// @param worker - the worker index
+//
+void updateBand(void *argument, size_t worker)
+{
+  Board *board = (Board*) argument;
+  size_t first_row;
+  size_t last_row;
+
+  bandRows(board->height, worker, &first_row, &last_row);
+  updateRowRange(board, first_row, last_row);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step, splitting the rows
+/// into one band per worker of the pool.
+///
+/// @param board - the board
+//
+void updateBoardParallel(Board *board)
+{
+  refreshHalo(board);
+  runWorkers(updateBand, board);
+  swapGenerations(board);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies one tile of the current generation together with a halo of
+/// margin cells into a local buffer. Cells beyond the edges of a bounded
+/// board are dead, on a torus they wrap around.
+///
+/// @param board - the board
+/// @param buffer - the local buffer, stride columns per row
+/// @param stride - the row stride of the buffer
+/// @param top - the board row of local row 0, may be negative
+/// @param left - the board column of local column 0, may be negative
+/// @param rows - the number of local rows
+/// @param columns - the number of local columns
+//
+void loadTile(const Board *board, uint8_t *buffer, size_t stride, ptrdiff_t top, ptrdiff_t left, size_t rows,
+              size_t columns)
+{
+  ptrdiff_t height = (ptrdiff_t) board->height;
+  ptrdiff_t width = (ptrdiff_t) board->width;
+
+  for (size_t local_row = 0; local_row < rows; local_row++)
+  {
+    ptrdiff_t row = top + (ptrdiff_t) local_row;
+    uint8_t *local_cells = buffer + local_row * stride;
+    const uint8_t *cells;
+
+    if (board->topology == TOPOLOGY_TORUS)
+    {
+      row = ((row % height) + height) % height;
+    }
+    else if (row < 0 || row >= height)
+    {
+      memset(local_cells, CELL_DEAD, columns);
+      continue;
+    }
+    cells = boardRow(board, board->current, row);
+
+    if (left >= 0 && left + (ptrdiff_t) columns <= width)
+    {
+      memcpy(local_cells, cells + left, columns);
+      continue;
+    }
+    for (size_t local_column = 0; local_column < columns; local_column++)
+    {
+      ptrdiff_t column = left + (ptrdiff_t) local_column;
+      if (board->topology == TOPOLOGY_TORUS)
+      {
+        local_cells[local_column] = cells[((column % width) + width) % width];
+      }
+      else
+      {
+        local_cells[local_column] = (column < 0 || column >= width) ? CELL_DEAD : cells[column];
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job of a temporally blocked pass. Each tile is loaded with a halo
+/// as wide as the number of generations, advanced that many generations in
+/// two cache resident buffers (the valid area shrinking by one cell per side
+/// and generation) and only its core is written to the next generation.
+/// Tiles are handed out through a shared counter.
+///
+/// @param argument - the BlockPass
+/// @param worker - the worker index
+//
+void advanceBlocks(void *argument, size_t worker)
+{
+  BlockPass *pass = (BlockPass*) argument;
+  const Board *board = pass->board;
+  ptrdiff_t margin = (ptrdiff_t) pass->generations;
+  size_t rows = BLOCK_TILE_HEIGHT + 2 * margin;
+  size_t stride = (BLOCK_TILE_WIDTH + 2 * margin + BOARD_ALIGNMENT - 1) / BOARD_ALIGNMENT * BOARD_ALIGNMENT;
+  uint8_t *buffers[2];
+  size_t tile;
+
+  (void) worker;
+  buffers[0] = (uint8_t*) aligned_alloc(BOARD_ALIGNMENT, 2 * rows * stride);
+  if (buffers[0] == NULL)
+  {
+    printf("-> Error: Out of memory in blocked pass!\n");
+    exit(ERROR);
+  }
+  buffers[1] = buffers[0] + rows * stride;
+
+  while ((tile = atomic_fetch_add(&pass->next_tile, 1)) < pass->tile_rows * pass->tile_columns)
+  {
+    ptrdiff_t tile_top = (ptrdiff_t) (tile / pass->tile_columns) * BLOCK_TILE_HEIGHT;
+    ptrdiff_t tile_left = (ptrdiff_t) (tile % pass->tile_columns) * BLOCK_TILE_WIDTH;
+    ptrdiff_t core_rows = (ptrdiff_t) board->height - tile_top;
+    ptrdiff_t core_columns = (ptrdiff_t) board->width - tile_left;
+    ptrdiff_t first_row = 1;
+    ptrdiff_t last_row;
+    ptrdiff_t first_column = 1;
+    ptrdiff_t last_column;
+
+    core_rows = (core_rows > BLOCK_TILE_HEIGHT) ? BLOCK_TILE_HEIGHT : core_rows;
+    core_columns = (core_columns > BLOCK_TILE_WIDTH) ? BLOCK_TILE_WIDTH : core_columns;
+    last_row = core_rows + 2 * margin - 1;
+    last_column = core_columns + 2 * margin - 1;
+    // Cells off a bounded board are never computed and stay dead
+    if (board->topology != TOPOLOGY_TORUS && (tile_top < margin || tile_left < margin ||
+        tile_top + core_rows + margin > (ptrdiff_t) board->height ||
+        tile_left + core_columns + margin > (ptrdiff_t) board->width))
+    {
+      ptrdiff_t end_row = margin + (ptrdiff_t) board->height - tile_top;
+      ptrdiff_t end_column = margin + (ptrdiff_t) board->width - tile_left;
+
+      first_row = (margin - tile_top > first_row) ? margin - tile_top : first_row;
+      first_column = (margin - tile_left > first_column) ? margin - tile_left : first_column;
+      last_row = (end_row < last_row) ? end_row : last_row;
+      last_column = (end_column < last_column) ? end_column : last_column;
+      memset(buffers[1], CELL_DEAD, rows * stride);
+    }
+    loadTile(board, buffers[0], stride, tile_top - margin, tile_left - margin, core_rows + 2 * margin,
+             core_columns + 2 * margin);
+
+    for (ptrdiff_t generation = 0; generation < margin; generation++)
+    {
+      const uint8_t *source = buffers[generation & 1];
+      uint8_t *target = buffers[(generation + 1) & 1];
+      ptrdiff_t from_row = (first_row > generation + 1) ? first_row : generation + 1;
+      ptrdiff_t to_row = (last_row < core_rows + 2 * margin - generation - 1) ?
+                         last_row : core_rows + 2 * margin - generation - 1;
+      ptrdiff_t from_column = (first_column > generation + 1) ? first_column : generation + 1;
+      ptrdiff_t to_column = (last_column < core_columns + 2 * margin - generation - 1) ?
+                            last_column : core_columns + 2 * margin - generation - 1;
+
+      for (ptrdiff_t row = from_row; row < to_row && from_column < to_column; row++)
+      {
+        updateRow(source + (row - 1) * stride + from_column, source + row * stride + from_column,
+                  source + (row + 1) * stride + from_column, target + row * stride + from_column,
+                  to_column - from_column);
+      }
+    }
+
+    for (ptrdiff_t row = 0; row < core_rows; row++)
+    {
+      memcpy(boardRow(board, board->next, tile_top + row) + tile_left,
+             buffers[margin & 1] + (row + margin) * stride + margin, core_columns);
+    }
+  }
+  free(buffers[0]);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances the board with temporal blocking: every pass streams the board
+/// through memory once for up to --block-generations generations. Passes
+/// are spread over the worker pool tile by tile.
+///
+/// @param board - the board
+/// @param generations - the number of generations to advance
+//
+void advanceBoardBlocked(Board *board, size_t generations)
+{
+  BlockPass pass;
+
+  pass.board = board;
+  pass.tile_rows = (board->height + BLOCK_TILE_HEIGHT - 1) / BLOCK_TILE_HEIGHT;
+  pass.tile_columns = (board->width + BLOCK_TILE_WIDTH - 1) / BLOCK_TILE_WIDTH;
+  while (generations > 0)
+  {
+    pass.generations = (generations < block_generations) ? generations : block_generations;
+    atomic_init(&pass.next_tile, 0);
+    runWorkers(advanceBlocks, &pass);
+    swapGenerations(board);
+    generations -= pass.generations;
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step with a single
+/// blocked pass.
+///
+/// @param board - the board
+//
+void updateBoardBlocked(Board *board)
+{
+  advanceBoardBlocked(board, 1);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Waits until a neighbouring band has completed a generation. Spins for a
+/// short while before yielding, so oversubscribed pools still progress.
+///
+/// @param progress - the progress of the neighbouring band
+/// @param generation - the generation to wait for
+//
+void waitForBand(BandProgress *progress, size_t generation)
+{
+  size_t spins = 0;
+
+  while (atomic_load_explicit(&progress->generation, memory_order_acquire) < generation)
+  {
+    if (++spins >= PIPELINE_SPINS)
+    {
+      sched_yield();
+      spins = 0;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job of a pipelined run. The band of the worker computes generation
+/// g + 1 as soon as both neighbouring bands have completed generation g: by
+/// then the rows it reads are final and the neighbours no longer read the
+/// plane it overwrites. There is no global barrier between generations, so
+/// bands drift apart as far as their neighbours allow.
+///
+/// @param argument - the PipelinePass
+/// @param worker - the worker index, equal to the band index
+//
+void advancePipelinedBand(void *argument, size_t worker)
+{
+  PipelinePass *pass = (PipelinePass*) argument;
+  Board *board = pass->board;
+  size_t band_count = pass->band_count;
+  size_t width = board->width;
+  size_t first_row = board->height * worker / band_count;
+  size_t last_row = board->height * (worker + 1) / band_count;
+  uint8_t *planes[2] = { board->current, board->next };
+  BandProgress *above = NULL;
+  BandProgress *below = NULL;
+  int torus = (board->topology == TOPOLOGY_TORUS);
+
+  if (worker >= band_count)
+  {
+    return;
+  }
+  // On a torus the first and last band are neighbours as well
+  if (worker > 0 || torus)
+  {
+    above = &pass->progress[(worker + band_count - 1) % band_count];
+  }
+  if (worker + 1 < band_count || torus)
+  {
+    below = &pass->progress[(worker + 1) % band_count];
+  }
+
+  for (size_t generation = 0; generation < pass->generations; generation++)
+  {
+    uint8_t *source = planes[generation & 1];
+    uint8_t *target = planes[(generation + 1) & 1];
+
+    if (above != NULL)
+    {
+      waitForBand(above, generation);
+    }
+    if (below != NULL)
+    {
+      waitForBand(below, generation);
+    }
+
+    for (size_t row = first_row; row < last_row; row++)
+    {
+      uint8_t *new_cells = boardRow(board, target, row);
+
+      updateRow(boardRow(board, source, (ptrdiff_t) row - 1), boardRow(board, source, row),
+                boardRow(board, source, row + 1), new_cells, width);
+      if (torus)
+      {
+        new_cells[-1] = new_cells[width - 1];
+        new_cells[width] = new_cells[0];
+      }
+    }
+    // The halo rows mirror the first and last row, their owners keep them
+    if (torus && first_row == 0)
+    {
+      memcpy(boardRow(board, target, board->height) - 1, boardRow(board, target, 0) - 1, width + 2);
+    }
+    if (torus && last_row == board->height)
+    {
+      memcpy(boardRow(board, target, -1) - 1, boardRow(board, target, board->height - 1) - 1, width + 2);
+    }
+
+    atomic_store_explicit(&pass->progress[worker].generation, generation + 1, memory_order_release);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances the board with one band per worker, synchronizing every band
+/// only with its two neighbours through per-band generation counters.
+///
+/// @param board - the board
+/// @param generations - the number of generations to advance
+//
+void advanceBoardPipelined(Board *board, size_t generations)
+{
+  PipelinePass pass;
+
+  pass.board = board;
+  pass.generations = generations;
+  pass.band_count = (worker_pool.size < board->height) ? worker_pool.size : board->height;
+  pass.progress = (BandProgress*) aligned_alloc(BOARD_ALIGNMENT, pass.band_count * sizeof(BandProgress));
+  if (pass.progress == NULL)
+  {
+    printf("-> Error: Out of memory in pipelined run!\n");
+    exit(ERROR);
+  }
+  for (size_t band = 0; band < pass.band_count; band++)
+  {
+    atomic_init(&pass.progress[band].generation, 0);
+  }
+
+  refreshHalo(board);
+  runWorkers(advancePipelinedBand, &pass);
+  if (generations & 1)
+  {
+    swapGenerations(board);
+  }
+  free(pass.progress);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step with the pipelined
+/// bands.
+///
+/// @param board - the board
+//
+void updateBoardPipelined(Board *board)
+{
+  advanceBoardPipelined(board, 1);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Pushes a task at the bottom of a deque. Only the owner may push.
+///
+/// @param deque - the deque of the calling worker
+/// @param task - the task
+//
+void pushTask(TaskDeque *deque, size_t task)
+{
+  long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+
+  atomic_store_explicit(&deque->tasks[bottom % deque->capacity], task, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Takes the most recently pushed task from a deque. Only the owner may take.
+///
+/// @param deque - the deque of the calling worker
+///
+/// @return the task or TASK_EMPTY
+//
+size_t takeTask(TaskDeque *deque)
+{
+  long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  long top;
+  size_t task = TASK_EMPTY;
+
+  atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+  if (top <= bottom)
+  {
+    task = atomic_load_explicit(&deque->tasks[bottom % deque->capacity], memory_order_relaxed);
+    if (top == bottom)
+    {
+      // Last task, race the thieves for it
+      if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                   memory_order_relaxed))
+      {
+        task = TASK_EMPTY;
+      }
+      atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+  }
+  else
+  {
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+  }
+  return task;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Steals the oldest task from another worker's deque.
+///
+/// @param deque - the deque of the victim
+///
+/// @return the task, TASK_EMPTY or TASK_ABORT if another thief won the race
+//
+size_t stealTask(TaskDeque *deque)
+{
+  long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  long bottom;
+  size_t task;
+
+  atomic_thread_fence(memory_order_seq_cst);
+  bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+  if (top >= bottom)
+  {
+    return TASK_EMPTY;
+  }
+  task = atomic_load_explicit(&deque->tasks[top % deque->capacity], memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                               memory_order_relaxed))
+  {
+    return TASK_ABORT;
+  }
+  return task;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Computes the next generation of one activity tile and records whether it
+/// changed.
+///
+/// @param board - the board with an up to date halo
+/// @param tile - the tile index
+//
+void updateTile(Board *board, size_t tile)
+{
+  size_t first_row = tile / board->tile_columns * ACTIVITY_TILE_HEIGHT;
+  size_t first_column = tile % board->tile_columns * ACTIVITY_TILE_WIDTH;
+  size_t last_row = (first_row + ACTIVITY_TILE_HEIGHT < board->height) ? first_row + ACTIVITY_TILE_HEIGHT :
+                    board->height;
+  size_t columns = (first_column + ACTIVITY_TILE_WIDTH < board->width) ? ACTIVITY_TILE_WIDTH :
+                   board->width - first_column;
+  uint8_t changed = 0;
+
+  for (size_t row = first_row; row < last_row; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row) + first_column;
+    uint8_t *new_cells = boardRow(board, board->next, row) + first_column;
+
+    updateRow(boardRow(board, board->current, (ptrdiff_t) row - 1) + first_column, cells,
+              boardRow(board, board->current, row + 1) + first_column, new_cells, columns);
+    changed |= (memcmp(cells, new_cells, columns) != 0);
+  }
+  board->new_changed[tile] = changed;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job of a work-stealing generation. The worker pushes its share of
+/// the active tiles onto its own deque and works through it; once it runs
+/// dry it steals from the other workers until every tile is done.
+///
+/// @param argument - the StealPass
+/// @param worker - the worker index
+//
+void updateStolenTiles(void *argument, size_t worker)
+{
+  StealPass *pass = (StealPass*) argument;
+  TaskDeque *own = &pass->deques[worker];
+  size_t first = pass->active_count * worker / worker_pool.size;
+  size_t last = pass->active_count * (worker + 1) / worker_pool.size;
+  size_t victim = worker;
+  size_t task;
+
+  for (size_t index = last; index > first; index--)
+  {
+    pushTask(own, pass->active_tiles[index - 1]);
+  }
+
+  while (atomic_load_explicit(&pass->remaining, memory_order_acquire) > 0)
+  {
+    task = takeTask(own);
+    while (task == TASK_EMPTY || task == TASK_ABORT)
+    {
+      if (atomic_load_explicit(&pass->remaining, memory_order_acquire) == 0)
+      {
+        return;
+      }
+      victim = (victim + 1) % worker_pool.size;
+      task = (victim == worker) ? TASK_EMPTY : stealTask(&pass->deques[victim]);
+      if (task == TASK_EMPTY && victim == worker)
+      {
+        sched_yield();
+      }
+    }
+    updateTile(pass->board, task);
+    atomic_fetch_sub_explicit(&pass->remaining, 1, memory_order_release);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Allocates the deques and the active tile list of the work-stealing engine
+/// for a board, sized for the worker pool. The board keeps them for all its
+/// generations and freeBoard releases them.
+///
+/// @param board - the board
+///
+/// @return the pass, exits if out of memory
+//
+StealPass *allocateStealPass(Board *board)
+{
+  size_t tile_count = board->tile_rows * board->tile_columns;
+  size_t capacity = tile_count / worker_pool.size + 1;
+  size_t deques_size = (worker_pool.size * sizeof(TaskDeque) + BOARD_ALIGNMENT - 1) / BOARD_ALIGNMENT *
+                       BOARD_ALIGNMENT;
+  StealPass *pass = (StealPass*) malloc(sizeof(StealPass));
+  atomic_size_t *tasks = (atomic_size_t*) malloc(worker_pool.size * capacity * sizeof(atomic_size_t));
+
+  if (pass == NULL || tasks == NULL)
+  {
+    printf("-> Error: Out of memory in work-stealing run!\n");
+    exit(ERROR);
+  }
+  pass->board = board;
+  pass->active_tiles = (size_t*) malloc(tile_count * sizeof(size_t));
+  pass->deques = (TaskDeque*) aligned_alloc(BOARD_ALIGNMENT, deques_size);
+  if (pass->active_tiles == NULL || pass->deques == NULL)
+  {
+    printf("-> Error: Out of memory in work-stealing run!\n");
+    exit(ERROR);
+  }
+  for (size_t worker = 0; worker < worker_pool.size; worker++)
+  {
+    pass->deques[worker].capacity = capacity;
+    pass->deques[worker].tasks = tasks + worker * capacity;
+  }
+  return pass;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances the board recomputing only the tiles that can change: a tile is
+/// active if it or one of its eight neighbours changed in the previous
+/// generation. The active tiles of each generation are balanced over the
+/// worker pool with work-stealing deques, so a few hotspots still keep all
+/// workers busy. Skipped tiles are stable, so the older plane already holds
+/// their next generation.
+///
+/// @param board - the board
+/// @param generations - the number of generations to advance
+//
+void advanceBoardStealing(Board *board, size_t generations)
+{
+  size_t tile_count = board->tile_rows * board->tile_columns;
+  int valid = (board->activity_generation == board->generation);
+  StealPass *pass;
+
+  if (board->steal == NULL)
+  {
+    board->steal = allocateStealPass(board);
+  }
+  pass = board->steal;
+
+  for (size_t generation = 0; generation < generations; generation++)
+  {
+    uint8_t *changed;
+
+    pass->active_count = 0;
+    for (size_t tile_row = 0; tile_row < board->tile_rows; tile_row++)
+    {
+      for (size_t tile_column = 0; tile_column < board->tile_columns; tile_column++)
+      {
+        int active = !valid;
+        for (ptrdiff_t offset_y = -1; offset_y <= 1 && !active; offset_y++)
+        {
+          for (ptrdiff_t offset_x = -1; offset_x <= 1 && !active; offset_x++)
+          {
+            size_t neighbour_row = tile_row + offset_y;
+            size_t neighbour_column = tile_column + offset_x;
+            if (board->topology == TOPOLOGY_TORUS)
+            {
+              neighbour_row = (tile_row + board->tile_rows + offset_y) % board->tile_rows;
+              neighbour_column = (tile_column + board->tile_columns + offset_x) % board->tile_columns;
+            }
+            else if (neighbour_row >= board->tile_rows || neighbour_column >= board->tile_columns)
+            {
+              continue;
+            }
+            active = board->changed[neighbour_row * board->tile_columns + neighbour_column];
+          }
+        }
+        if (active)
+        {
+          pass->active_tiles[pass->active_count++] = tile_row * board->tile_columns + tile_column;
+        }
+      }
+    }
+
+    memset(board->new_changed, 0, tile_count);
+    for (size_t worker = 0; worker < worker_pool.size; worker++)
+    {
+      atomic_init(&pass->deques[worker].top, 0);
+      atomic_init(&pass->deques[worker].bottom, 0);
+    }
+    atomic_init(&pass->remaining, pass->active_count);
+    refreshHalo(board);
+    runWorkers(updateStolenTiles, pass);
+    swapGenerations(board);
+
+    changed = board->changed;
+    board->changed = board->new_changed;
+    board->new_changed = changed;
+    valid = 1;
+  }
+  board->activity_generation = board->generation + generations;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the cells of the board for the next step with the
+/// work-stealing scheduler.
+///
+/// @param board - the board
+//
+void updateBoardStealing(Board *board)
+{
+  advanceBoardStealing(board, 1);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances the board by several generations with the given engine.
+///
+/// @param engine - the engine
+/// @param board - the board
+/// @param generations - the number of generations to advance
+//
+void advanceBoard(const Engine *engine, Board *board, size_t generations)
+{
+  if (engine->advance != NULL)
+  {
+    engine->advance(board, generations);
+  }
+  else
+  {
+    for (size_t generation = 0; generation < generations; generation++)
+    {
+      engine->update(board);
+    }
+  }
+  board->generation += generations;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the current generation of the board in the config file format,
+/// '#' for live and '.' for dead cells, without a newline after the last
+/// row.
+///
+/// @param board - the board
+/// @param file_path - path of the file to write
+///
+/// @return 0 if the file could be written, otherwise a value > 1
+//
+int writeConfigFile(Board *board, const char *file_path)
+{
+  FILE *output = openOutput(file_path);
+  char *line = (char*) malloc(board->width + 1);
+  int result = OK;
+
+  if (output == NULL || line == NULL)
+  {
+    printf("-> Error: Could not write configuration file \"%s\"!\n", file_path);
+    if (output != NULL)
+    {
+      fclose(output);
+    }
+    free(line);
+    return ERROR;
+  }
+  line[board->width] = '\n';
+  for (size_t row = 0; row < board->height && result == OK; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+
+    for (size_t column = 0; column < board->width; column++)
+    {
+      line[column] = cells[column] ? '#' : '.';
+    }
+    if (fwrite(line, 1, board->width + (row + 1 < board->height), output) != board->width + (row + 1 < board->height))
+    {
+      result = ERROR;
+    }
+  }
+  if (fclose(output) != 0 || result != OK)
+  {
+    printf("-> Error: Could not write configuration file \"%s\"!\n", file_path);
+    result = ERROR;
+  }
+  free(line);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Looks up a quadtree node and adds it if it is new.
+///
+/// @param table - the table
+/// @param level - the level of the node, 3 for leaves
+/// @param key - the cells of a leaf or the children of a node
+/// @param created - set to 1 if the node was added, otherwise 0
+///
+/// @return the index of the node
+//
+size_t internQuadNode(QuadTable *table, size_t level, const uint64_t key[4], int *created)
+{
+  uint64_t hash = level * 0x9e3779b97f4a7c15ULL;
+  size_t slot;
+
+  if (table->count * 2 >= table->capacity)
+  {
+    size_t capacity = table->capacity ? 2 * table->capacity : MACROCELL_TABLE_SIZE;
+    QuadNode *entries = (QuadNode*) calloc(capacity, sizeof(QuadNode));
+
+    if (entries == NULL)
+    {
+      printf("-> Error: Out of memory in macrocell writer!\n");
+      exit(ERROR);
+    }
+    for (size_t old = 0; old < table->capacity; old++)
+    {
+      if (table->entries[old].index != 0)
+      {
+        uint64_t rehash = table->entries[old].level * 0x9e3779b97f4a7c15ULL;
+        for (size_t part = 0; part < 4; part++)
+        {
+          rehash = (rehash ^ table->entries[old].key[part]) * 0xbf58476d1ce4e5b9ULL;
+          rehash ^= rehash >> 31;
+        }
+        for (slot = rehash & (capacity - 1); entries[slot].index != 0; slot = (slot + 1) & (capacity - 1));
+        entries[slot] = table->entries[old];
+      }
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+  }
+
+  for (size_t part = 0; part < 4; part++)
+  {
+    hash = (hash ^ key[part]) * 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 31;
+  }
+  for (slot = hash & (table->capacity - 1); table->entries[slot].index != 0; slot = (slot + 1) & (table->capacity - 1))
+  {
+    QuadNode *entry = &table->entries[slot];
+    if (entry->level == level && !memcmp(entry->key, key, sizeof(entry->key)))
+    {
+      *created = 0;
+      return entry->index;
+    }
+  }
+  table->count++;
+  table->entries[slot].level = level;
+  memcpy(table->entries[slot].key, key, sizeof(table->entries[slot].key));
+  table->entries[slot].index = table->count;
+  *created = 1;
+  return table->count;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the quadtree node covering a square of the board, after writing
+/// all of its children that were not written before. Parts of the square
+/// beyond the board are dead.
+///
+/// @param writer - the writer
+/// @param level - the level of the node, the square is 2^level cells wide
+/// @param top - the row of the upper left corner
+/// @param left - the column of the upper left corner
+///
+/// @return the index of the node, 0 if the square is empty
+//
+size_t writeMacrocellNode(MacrocellWriter *writer, size_t level, size_t top, size_t left)
+{
+  Board *board = writer->board;
+  uint64_t key[4] = { 0, 0, 0, 0 };
+  size_t index;
+  int created;
+
+  if (top >= board->height || left >= board->width)
+  {
+    return 0;
+  }
+  if (level == MACROCELL_LEAF_LEVEL)
+  {
+    for (size_t row = 0; row < 8 && top + row < board->height; row++)
+    {
+      uint8_t *cells = boardRow(board, board->current, top + row) + left;
+      for (size_t column = 0; column < 8 && left + column < board->width; column++)
+      {
+        key[0] |= (uint64_t) cells[column] << (8 * row + column);
+      }
+    }
+    if (key[0] == 0)
+    {
+      return 0;
+    }
+    index = internQuadNode(&writer->table, level, key, &created);
+    if (created)
+    {
+      // Rows end with '$', dead cells ending a row and empty rows ending
+      // the leaf are left out
+      char line[8 * 9 + 2];
+      size_t length = 0;
+      for (size_t row = 0; row < 8 && (key[0] >> (8 * row)) != 0; row++)
+      {
+        uint8_t bits = (uint8_t) (key[0] >> (8 * row));
+        for (size_t column = 0; (bits >> column) != 0; column++)
+        {
+          line[length++] = ((bits >> column) & 1) ? '*' : '.';
+        }
+        line[length++] = '$';
+      }
+      line[length++] = '\n';
+      fwrite(line, 1, length, writer->output);
+    }
+    return index;
+  }
+
+  size_t half = (size_t) 1 << (level - 1);
+  key[0] = writeMacrocellNode(writer, level - 1, top, left);
+  key[1] = writeMacrocellNode(writer, level - 1, top, left + half);
+  key[2] = writeMacrocellNode(writer, level - 1, top + half, left);
+  key[3] = writeMacrocellNode(writer, level - 1, top + half, left + half);
+  if ((key[0] | key[1] | key[2] | key[3]) == 0)
+  {
+    return 0;
+  }
+  index = internQuadNode(&writer->table, level, key, &created);
+  if (created)
+  {
+    fprintf(writer->output, "%zu %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", level, key[0], key[1], key[2],
+            key[3]);
+  }
+  return index;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the current generation of the board in Golly's macrocell format.
+/// Identical squares of the board are stored once: the quadtree is built
+/// bottom up in a single pass over the board, and every node is written the
+/// moment it first appears, so only the table of distinct nodes is kept in
+/// memory. The board size is recorded in a comment.
+///
+/// @param board - the board
+/// @param file_path - path of the file to write
+///
+/// @return 0 if the file could be written, otherwise a value > 1
+//
+int writeMacrocellFile(Board *board, const char *file_path)
+{
+  MacrocellWriter writer = { board, openOutput(file_path), { NULL, 0, 0 } };
+  size_t level = MACROCELL_LEAF_LEVEL;
+  int result = OK;
+
+  if (writer.output == NULL)
+  {
+    printf("-> Error: Could not write macrocell file \"%s\"!\n", file_path);
+    return ERROR;
+  }
+  while (((size_t) 1 << level) < board->height || ((size_t) 1 << level) < board->width)
+  {
+    level++;
+  }
+  fprintf(writer.output, MACROCELL_HEADER " (gol " GOL_VERSION ")\n#R B3/S23\n#C board %zux%zu\n", board->width,
+          board->height);
+  if (board->generation != 0)
+  {
+    fprintf(writer.output, "#G %zu\n", board->generation);
+  }
+  // An empty board still needs a root node
+  if (writeMacrocellNode(&writer, level, 0, 0) == 0)
+  {
+    fprintf(writer.output, "$\n");
+  }
+  if (ferror(writer.output) | fclose(writer.output))
+  {
+    printf("-> Error: Could not write macrocell file \"%s\"!\n", file_path);
+    result = ERROR;
+  }
+  if (verbose)
+  {
+    printf("-> Info: %zu distinct quadtree nodes written\n", writer.table.count);
+  }
+  free(writer.table.entries);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies the live cells of a macrocell node into the board.
+///
+/// @param board - the board
+/// @param nodes - the nodes read, nodes[index - 1] has index index
+/// @param index - the index of the node
+/// @param top - the board row of the upper left corner, may be negative
+/// @param left - the board column of the upper left corner, may be negative
+//
+void drawMacrocellNode(Board *board, const MacrocellNode *nodes, size_t index, int64_t top, int64_t left)
+{
+  const MacrocellNode *node;
+
+  if (index == 0)
+  {
+    return;
+  }
+  node = &nodes[index - 1];
+  if (top + (int64_t) node->top >= (int64_t) board->height || left + (int64_t) node->left >= (int64_t) board->width ||
+      top + (int64_t) node->bottom < 0 || left + (int64_t) node->right < 0)
+  {
+    return;
+  }
+  if (node->level == MACROCELL_LEAF_LEVEL)
+  {
+    for (int64_t row = 0; row < 8; row++)
+    {
+      for (int64_t column = 0; column < 8; column++)
+      {
+        if (((node->key[0] >> (8 * row + column)) & 1) && top + row >= 0 && top + row < (int64_t) board->height &&
+            left + column >= 0 && left + column < (int64_t) board->width)
+        {
+          boardRow(board, board->current, top + row)[left + column] = CELL_ALIVE;
+        }
+      }
+    }
+    return;
+  }
+
+  int64_t half = (int64_t) 1 << (node->level - 1);
+  drawMacrocellNode(board, nodes, node->key[0], top, left);
+  drawMacrocellNode(board, nodes, node->key[1], top, left + half);
+  drawMacrocellNode(board, nodes, node->key[2], top + half, left);
+  drawMacrocellNode(board, nodes, node->key[3], top + half, left + half);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies the next line of a buffer including its newline, like fgets.
+/// Longer lines are split into pieces of the line size.
+///
+/// @param cursor - the position in the buffer, moved past the line
+/// @param line - receives the line, terminated by '\0'
+/// @param size - the size of the line
+///
+/// @return 1 if a line was copied, 0 at the end of the buffer
+//
+static inline int nextLine(const char **cursor, char *line, size_t size)
+{
+  size_t length = 0;
+
+  while (length + 1 < size && (*cursor)[length] != '\0' && (length == 0 || (*cursor)[length - 1] != '\n'))
+  {
+    line[length] = (*cursor)[length];
+    length++;
+  }
+  line[length] = '\0';
+  *cursor += length;
+  return length != 0;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a pattern in Golly's macrocell format onto a new board. Boards
+/// written by gol keep their size, other patterns get a board cropped to
+/// their live cells. Only leaves of 8x8 cells and B3/S23 are supported.
+///
+/// @param contents - the contents of the macrocell file, terminated by '\0'
+/// @param board - receives the board
+///
+/// @return 0 if the pattern could be read, otherwise a value > 1
+//
+int readMacrocell(const char *contents, Board **board)
+{
+  const char *cursor = contents;
+  MacrocellNode *nodes = NULL;
+  size_t node_count = 0;
+  size_t capacity = 0;
+  size_t board_height = 0;
+  size_t board_width = 0;
+  size_t generation = 0;
+  size_t line_number = 0;
+  char line[256];
+  int result = OK;
+
+  *board = NULL;
+  while (result == OK && nextLine(&cursor, line, sizeof(line)))
+  {
+    MacrocellNode node = { { 0, 0, 0, 0 }, MACROCELL_LEAF_LEVEL, UINT64_MAX, UINT64_MAX, 0, 0 };
+
+    line_number++;
+    if ((line[0] == '#' || line[0] == '[') && strchr(line, '\n') == NULL)
+    {
+      // Comments may be longer than the line, their rest is skipped
+      cursor += strcspn(cursor, "\n");
+      cursor += (*cursor == '\n');
+    }
+    if (line[0] == '[' || line[0] == '\n' || line[0] == '\r')
+    {
+      continue;
+    }
+    if (line[0] == '#')
+    {
+      if (line[1] == 'R' && strncmp(line + 2, " B3/S23", 7) && strncmp(line + 2, " b3/s23", 7) &&
+          strncmp(line + 2, " 23/3", 5))
+      {
+        // A bare "#R" has no blank to skip
+        const char *rule = line + 2 + (line[2] == ' ');
+        printf("-> Error: Unsupported macrocell rule \"%.*s\"!\n", (int) strcspn(rule, "\r\n"), rule);
+        result = ERROR;
+      }
+      sscanf(line, "#C board %zux%zu", &board_width, &board_height);
+      sscanf(line, "#G %zu", &generation);
+      continue;
+    }
+
+    if (line[0] == '.' || line[0] == '*' || line[0] == '$')
+    {
+      size_t row = 0;
+      size_t column = 0;
+      for (char *character = line; *character != '\0' && *character != '\n' && *character != '\r'; character++)
+      {
+        if (*character == '$')
+        {
+          row++;
+          column = 0;
+        }
+        else if (row < 8 && column < 8 && (*character == '.' || *character == '*'))
+        {
+          if (*character == '*')
+          {
+            node.key[0] |= (uint64_t) 1 << (8 * row + column);
+            node.top = (row < node.top) ? row : node.top;
+            node.left = (column < node.left) ? column : node.left;
+            node.bottom = row;
+            node.right = (column > node.right) ? column : node.right;
+          }
+          column++;
+        }
+        else
+        {
+          result = ERROR;
+        }
+      }
+    }
+    else if (sscanf(line, "%zu %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64, &node.level, &node.key[0], &node.key[1],
+                    &node.key[2], &node.key[3]) == 5 && node.level > MACROCELL_LEAF_LEVEL &&
+             node.level <= MACROCELL_MAX_LEVEL)
+    {
+      uint64_t half = (uint64_t) 1 << (node.level - 1);
+      for (size_t part = 0; part < 4; part++)
+      {
+        const MacrocellNode *child;
+        uint64_t row_offset = (part & 2) ? half : 0;
+        uint64_t column_offset = (part & 1) ? half : 0;
+
+        if (node.key[part] == 0)
+        {
+          continue;
+        }
+        if (node.key[part] > node_count)
+        {
+          result = ERROR;
+          break;
+        }
+        child = &nodes[node.key[part] - 1];
+        if (child->level + 1 != node.level || child->top == UINT64_MAX)
+        {
+          result = ERROR;
+          break;
+        }
+        node.top = (child->top + row_offset < node.top) ? child->top + row_offset : node.top;
+        node.left = (child->left + column_offset < node.left) ? child->left + column_offset : node.left;
+        node.bottom = (child->bottom + row_offset > node.bottom) ? child->bottom + row_offset : node.bottom;
+        node.right = (child->right + column_offset > node.right) ? child->right + column_offset : node.right;
+      }
+    }
+    else
+    {
+      result = ERROR;
+    }
+    if (result != OK)
+    {
+      printf("-> Error: Invalid macrocell node in line %zu!\n", line_number);
+      break;
+    }
+
+    if (node_count == capacity)
+    {
+      MacrocellNode *grown;
+      capacity = capacity ? 2 * capacity : MACROCELL_TABLE_SIZE;
+      grown = (MacrocellNode*) realloc(nodes, capacity * sizeof(MacrocellNode));
+      if (grown == NULL)
+      {
+        result = ERROR;
+        break;
+      }
+      nodes = grown;
+    }
+    nodes[node_count++] = node;
+  }
+
+  if (result == OK && node_count == 0)
+  {
+    printf("-> Error: Macrocell file has no nodes!\n");
+    result = ERROR;
+  }
+  if (result == OK)
+  {
+    const MacrocellNode *root = &nodes[node_count - 1];
+    int64_t top = 0;
+    int64_t left = 0;
+
+    if (board_height == 0 || board_width == 0)
+    {
+      // Without a recorded size the board is cropped to the live cells
+      int empty = (root->top == UINT64_MAX);
+      board_height = empty ? 1 : root->bottom - root->top + 1;
+      board_width = empty ? 1 : root->right - root->left + 1;
+      top = empty ? 0 : -(int64_t) root->top;
+      left = empty ? 0 : -(int64_t) root->left;
+    }
+    if (verbose)
+    {
+      printf("-> Info: Rows = %zu, Columns = %zu, %zu quadtree nodes\n", board_height, board_width, node_count);
+    }
+    // Patterns spread over a huge universe do not fit a flat board
+    result = (board_width > MACROCELL_MAX_CELLS / board_height) ? ERROR :
+             allocateBoard(board, board_height, board_width);
+    if (result != OK)
+    {
+      printf("-> Error: Could not allocate a board of %zux%zu cells!\n", board_width, board_height);
+    }
+    if (result == OK)
+    {
+      if (root->top != UINT64_MAX)
+      {
+        drawMacrocellNode(*board, nodes, node_count, top, left);
+      }
+      (*board)->generation = generation;
+    }
+  }
+  free(nodes);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Parses a signed decimal integer, skipping leading blanks. Magnitudes of
+/// 2^62 and above are rejected, so differences of two numbers still fit.
+///
+/// @param cursor - the position to parse from, moved past the number
+/// @param value - receives the number
+///
+/// @return 0 if a number in range was found, otherwise a value > 1
+//
+static inline int parseInteger(const char **cursor, int64_t *value)
+{
+  const char *position = *cursor;
+  int negative = 0;
+  uint64_t magnitude = 0;
+
+  while (*position == ' ' || *position == '\t')
+  {
+    position++;
+  }
+  if (*position == '-' || *position == '+')
+  {
+    negative = (*position++ == '-');
+  }
+  if (*position < '0' || *position > '9')
+  {
+    return ERROR;
+  }
+  while (*position >= '0' && *position <= '9')
+  {
+    magnitude = magnitude * 10 + (uint64_t) (*position++ - '0');
+    if (magnitude >= ((uint64_t) 1 << 62))
+    {
+      return ERROR;
+    }
+  }
+  *value = negative ? -(int64_t) magnitude : (int64_t) magnitude;
+  *cursor = position;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a pattern in the Life 1.06 format, one "x y" coordinate pair per
+/// live cell, onto a new board sized to the bounding box of the cells.
+///
+/// @param contents - the contents of the Life 1.06 file, terminated by '\0'
+/// @param board - receives the board
+///
+/// @return 0 if the pattern could be read, otherwise a value > 1
+//
+int readLife106(const char *contents, Board **board)
+{
+  int64_t *coordinates = NULL;
+  size_t cell_count = 0;
+  size_t capacity = 0;
+  int64_t top = INT64_MAX;
+  int64_t left = INT64_MAX;
+  int64_t bottom = INT64_MIN;
+  int64_t right = INT64_MIN;
+  size_t line_number = 1;
+  const char *cursor;
+  int result = OK;
+
+  *board = NULL;
+  for (cursor = contents; *cursor != '\0' && result == OK; line_number++)
+  {
+    int64_t x;
+    int64_t y;
+
+    // The header and comment lines start with '#', blank lines are skipped
+    if (*cursor != '#' && *cursor != '\n' && *cursor != '\r')
+    {
+      if (parseInteger(&cursor, &x) || parseInteger(&cursor, &y))
+      {
+        printf("-> Error: Invalid or out of range coordinates in line %zu!\n", line_number);
+        result = ERROR;
+        break;
+      }
+      if (cell_count == capacity)
+      {
+        int64_t *grown;
+        capacity = capacity ? 2 * capacity : READ_CHUNK_SIZE / sizeof(int64_t);
+        grown = (int64_t*) realloc(coordinates, 2 * capacity * sizeof(int64_t));
+        if (grown == NULL)
+        {
+          result = ERROR;
+          break;
+        }
+        coordinates = grown;
+      }
+      coordinates[2 * cell_count] = y;
+      coordinates[2 * cell_count + 1] = x;
+      cell_count++;
+      top = (y < top) ? y : top;
+      bottom = (y > bottom) ? y : bottom;
+      left = (x < left) ? x : left;
+      right = (x > right) ? x : right;
+    }
+    while (*cursor != '\0' && *cursor != '\n')
+    {
+      cursor++;
+    }
+    cursor += (*cursor == '\n');
+  }
+
+  if (result == OK)
+  {
+    size_t board_height = cell_count ? (size_t) (bottom - top) + 1 : 1;
+    size_t board_width = cell_count ? (size_t) (right - left) + 1 : 1;
+
+    if (verbose)
+    {
+      printf("-> Info: Rows = %zu, Columns = %zu, %zu live cells\n", board_height, board_width, cell_count);
+    }
+    result = allocateBoard(board, board_height, board_width);
+    if (result != OK)
+    {
+      printf("-> Error: Could not allocate a board of %zux%zu cells!\n", board_width, board_height);
+    }
+    for (size_t cell = 0; result == OK && cell < cell_count; cell++)
+    {
+      boardRow(*board, (*board)->current, coordinates[2 * cell] - top)[coordinates[2 * cell + 1] - left] = CELL_ALIVE;
+    }
+  }
+  free(coordinates);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the live cells of the current generation in the Life 1.06
+/// format, columns as x and rows as y. Each row is formatted into a buffer
+/// of its own, its number only once.
+///
+/// @param board - the board
+/// @param file_path - path of the file to write
+///
+/// @return 0 if the file could be written, otherwise a value > 1
+//
+int writeLife106File(Board *board, const char *file_path)
+{
+  FILE *output = openOutput(file_path);
+  char *line = (char*) malloc(board->width * 44 + 1);
+  int result = OK;
+
+  if (output == NULL || line == NULL)
+  {
+    printf("-> Error: Could not write Life 1.06 file \"%s\"!\n", file_path);
+    if (output != NULL)
+    {
+      fclose(output);
+    }
+    free(line);
+    return ERROR;
+  }
+  fputs(LIFE106_HEADER "\n", output);
+  for (size_t row = 0; row < board->height && result == OK; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    char suffix[24];
+    size_t suffix_length = (size_t) sprintf(suffix, " %zu\n", row);
+    size_t length = 0;
+
+    for (size_t column = 0; column < board->width; column++)
+    {
+      char digits[20];
+      size_t digit_count = 0;
+      size_t value = column;
+
+      if (cells[column] == CELL_DEAD)
+      {
+        continue;
+      }
+      do
+      {
+        digits[digit_count++] = (char) ('0' + value % 10);
+        value /= 10;
+      } while (value != 0);
+      while (digit_count > 0)
+      {
+        line[length++] = digits[--digit_count];
+      }
+      memcpy(line + length, suffix, suffix_length);
+      length += suffix_length;
+    }
+    if (fwrite(line, 1, length, output) != length)
+    {
+      result = ERROR;
+    }
+  }
+  if (fclose(output) != 0 || result != OK)
+  {
+    printf("-> Error: Could not write Life 1.06 file \"%s\"!\n", file_path);
+    result = ERROR;
+  }
+  free(line);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a board from a file, "-" for the standard input, in one pass. Files
+/// starting with the macrocell or Life 1.06 header are read in that format,
+/// all others as config files.
+///
+/// @param file_path - path of the file
+/// @param board - receives the board
+///
+/// @return 0 if the board could be read, otherwise a value > 1
+//
+int loadBoardFile(const char *file_path, Board **board)
+{
+  char *contents;
+  size_t size;
+  size_t board_height = 0;
+  size_t board_width = 0;
+  int result;
+
+  *board = NULL;
+  if (readInput(file_path, &contents, &size))
+  {
+    return ERROR;
+  }
+  if (!strncmp(contents, MACROCELL_HEADER, strlen(MACROCELL_HEADER)))
+  {
+    result = readMacrocell(contents, board);
+  }
+  else if (!strncmp(contents, LIFE106_HEADER, strlen(LIFE106_HEADER)))
+  {
+    result = readLife106(contents, board);
+  }
+  else
+  {
+    result = checkConfigFile(contents, size, &board_height, &board_width) ||
+             fillBoard(contents, board, board_height, board_width);
+  }
+  free(contents);
+  return result ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Packs a row of cells into bits, column c into bit c % 64 of word c / 64.
+/// Eight cells at a time are gathered into a byte with a multiplication.
+///
+/// @param cells - the cells of the row
+/// @param width - the number of cells
+/// @param words - receives the packed row
+//
+void packCellRow(const uint8_t *cells, size_t width, uint64_t *words)
+{
+  size_t column = 0;
+
+  memset(words, 0, (width + 63) / 64 * sizeof(uint64_t));
+  for (; column + 8 <= width; column += 8)
+  {
+    uint64_t eight;
+
+    // Cell i is 0 or 1 in byte i, the product collects them in the top byte
+    memcpy(&eight, cells + column, sizeof(eight));
+    words[column / 64] |= ((eight * 0x0102040810204080ULL) >> 56) << (column % 64);
+  }
+  for (; column < width; column++)
+  {
+    words[column / 64] |= (uint64_t) cells[column] << (column % 64);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Packs a row of dots of the viewport into bits. At zoom 1 the dots are the
+/// cells, zoomed out a dot is live if any sampled cell of its block is.
+///
+/// @param board - the board
+/// @param viewport - the viewport
+/// @param dot_row - the row of dots, counted from the top of the viewport
+/// @param dots - the number of dots in the row
+/// @param words - receives the packed dots
+//
+void packViewportRow(Board *board, const Viewport *viewport, size_t dot_row, size_t dots, uint64_t *words)
+{
+  size_t zoom = viewport->zoom;
+  size_t sample = (zoom > VIEWPORT_SAMPLES) ? zoom / VIEWPORT_SAMPLES : 1;
+  size_t top = viewport->top + dot_row * zoom;
+  size_t available = (viewport->left >= board->width) ? 0 : (board->width - viewport->left + zoom - 1) / zoom;
+
+  memset(words, 0, (dots + 63) / 64 * sizeof(uint64_t));
+  dots = (dots < available) ? dots : available;
+  if (top >= board->height)
+  {
+    return;
+  }
+  if (zoom == 1)
+  {
+    packCellRow(boardRow(board, board->current, top) + viewport->left, dots, words);
+    return;
+  }
+  for (size_t dot = 0; dot < dots; dot++)
+  {
+    size_t left = viewport->left + dot * zoom;
+    uint8_t live = 0;
+
+    for (size_t cell_row = top; cell_row < top + zoom && cell_row < board->height && !live; cell_row += sample)
+    {
+      uint8_t *cells = boardRow(board, board->current, cell_row);
+      for (size_t cell_column = left; cell_column < left + zoom && cell_column < board->width; cell_column += sample)
+      {
+        live |= cells[cell_column];
+      }
+    }
+    words[dot / 64] |= (uint64_t) live << (dot % 64);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Formats a horizontal border of the board.
+///
+/// @param line - receives the border, 3 * columns + 4 bytes
+/// @param columns - the number of columns
+/// @param corner - the corner ending the border
+///
+/// @return the length of the border
+//
+size_t formatBorder(char *line, size_t columns, const char *corner)
+{
+  size_t length = 0;
+
+  for (size_t column = 0; column < columns; column++)
+  {
+    memcpy(line + length, "═", 3);
+    length += 3;
+  }
+  memcpy(line + length, corner, strlen(corner));
+  return length + strlen(corner);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Prints the window of the board that fits the viewport, after the top
+/// left corner printed by the caller. In cells mode at zoom 1 each
+/// character is a cell, zoomed out each one shades the density of its
+/// block, counted from at most VIEWPORT_SAMPLES x VIEWPORT_SAMPLES cells.
+/// The half-block and Braille modes pack the rows of dots into bits and
+/// look each character up from 2 or 8 of them. The cost depends on the size
+/// of the terminal only, not the board.
+///
+/// @param board - the board
+/// @param viewport - the viewport
+//
+void printViewport(Board *board, const Viewport *viewport)
+{
+  size_t zoom = viewport->zoom;
+  size_t sample = (zoom > VIEWPORT_SAMPLES) ? zoom / VIEWPORT_SAMPLES : 1;
+  size_t dot_width = RENDER_DOT_WIDTH[viewport->mode];
+  size_t dot_height = RENDER_DOT_HEIGHT[viewport->mode];
+  size_t rows = (viewport->top >= board->height) ? 0 :
+                (board->height - viewport->top + zoom * dot_height - 1) / (zoom * dot_height);
+  size_t columns = (viewport->left >= board->width) ? 0 :
+                   (board->width - viewport->left + zoom * dot_width - 1) / (zoom * dot_width);
+  size_t row_words;
+  uint64_t *words;
+  char *line;
+  size_t length;
+
+  rows = (rows < viewport->rows) ? rows : viewport->rows;
+  columns = (columns < viewport->columns) ? columns : viewport->columns;
+  row_words = (columns * dot_width + 63) / 64;
+  line = (char*) malloc(3 * columns + 8);
+  words = (uint64_t*) malloc((4 * row_words + 1) * sizeof(uint64_t));
+  if (line == NULL || words == NULL)
+  {
+    free(line);
+    free(words);
+    return;
+  }
+
+  fwrite(line, 1, formatBorder(line, columns, "╗\n"), stdout);
+  for (size_t row = 0; row < rows; row++)
+  {
+    size_t top = viewport->top + row * zoom;
+
+    memcpy(line, "║", 3);
+    length = 3;
+    for (size_t dot_row = 0; dot_row < dot_height && viewport->mode != RENDER_CELLS; dot_row++)
+    {
+      packViewportRow(board, viewport, row * dot_height + dot_row, columns * dot_width, words + dot_row * row_words);
+    }
+    for (size_t column = 0; column < columns && viewport->mode == RENDER_HALF; column++)
+    {
+      uint64_t upper = words[column / 64] >> (column % 64);
+      uint64_t lower = words[row_words + column / 64] >> (column % 64);
+      const char *glyph = HALF_BLOCKS[(upper & 1) | (lower & 1) << 1];
+
+      memcpy(line + length, glyph, strlen(glyph));
+      length += strlen(glyph);
+    }
+    for (size_t column = 0; column < columns && viewport->mode == RENDER_BRAILLE; column++)
+    {
+      size_t shift = (2 * column) % 64;
+      uint8_t pattern = BRAILLE_DOTS[0][(words[2 * column / 64] >> shift) & 3] |
+                        BRAILLE_DOTS[1][(words[row_words + 2 * column / 64] >> shift) & 3] |
+                        BRAILLE_DOTS[2][(words[2 * row_words + 2 * column / 64] >> shift) & 3] |
+                        BRAILLE_DOTS[3][(words[3 * row_words + 2 * column / 64] >> shift) & 3];
+
+      // U+2800 + pattern in UTF-8
+      line[length++] = (char) 0xe2;
+      line[length++] = (char) (0xa0 | pattern >> 6);
+      line[length++] = (char) (0x80 | (pattern & 0x3f));
+    }
+    for (size_t column = 0; column < columns && viewport->mode == RENDER_CELLS; column++)
+    {
+      size_t left = viewport->left + column * zoom;
+      const char *glyph;
+
+      if (zoom == 1)
+      {
+        glyph = boardRow(board, board->current, top)[left] ? "■" : "·";
+      }
+      else
+      {
+        size_t live = 0;
+        size_t samples = 0;
+
+        for (size_t cell_row = top; cell_row < top + zoom && cell_row < board->height; cell_row += sample)
+        {
+          uint8_t *cells = boardRow(board, board->current, cell_row);
+          for (size_t cell_column = left; cell_column < left + zoom && cell_column < board->width;
+               cell_column += sample)
+          {
+            live += cells[cell_column];
+            samples++;
+          }
+        }
+        glyph = SHADES[(live == 0) ? 0 : 1 + ((4 * live - 1) / samples > 3 ? 3 : (4 * live - 1) / samples)];
+      }
+      memcpy(line + length, glyph, strlen(glyph));
+      length += strlen(glyph);
+    }
+    memcpy(line + length, "║\n", 4);
+    fwrite(line, 1, length + 4, stdout);
+  }
+  printf("╚");
+  fwrite(line, 1, formatBorder(line, columns, "╝\n"), stdout);
+  if (rows < (board->height + zoom * dot_height - 1) / (zoom * dot_height) ||
+      columns < (board->width + zoom * dot_width - 1) / (zoom * dot_width) || zoom > 1)
+  {
+    size_t bottom = viewport->top + rows * zoom * dot_height;
+    size_t right = viewport->left + columns * zoom * dot_width;
+
+    printf("-> View: rows %zu-%zu, columns %zu-%zu of %zux%zu, zoom 1:%zu\n", viewport->top,
+           ((bottom < board->height) ? bottom : board->height) - 1, viewport->left,
+           ((right < board->width) ? right : board->width) - 1, board->height, board->width, zoom);
+  }
+  free(words);
+  free(line);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Prints the whole board to the console
+///
+/// @param board - the board
+//
+void printBoard(Board *board)
+{
+  Viewport whole = { 0, 0, 1, SIZE_MAX, SIZE_MAX, RENDER_CELLS };
+
+  printViewport(board, &whole);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Fits the viewport to the size of the terminal and keeps it on the board.
+/// Without a terminal the whole board is shown.
+///
+/// @param viewport - the viewport
+/// @param board - the board
+//
+void updateViewport(Viewport *viewport, Board *board)
+{
+  struct winsize size;
+
+  if (terminal_resized)
+  {
+    terminal_resized = 0;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > VIEWPORT_RESERVED_ROWS && size.ws_col > 2)
+    {
+      viewport->rows = size.ws_row - VIEWPORT_RESERVED_ROWS;
+      viewport->columns = size.ws_col - 2;
+    }
+    else
+    {
+      viewport->rows = SIZE_MAX;
+      viewport->columns = SIZE_MAX;
+    }
+  }
+  viewport->zoom = (viewport->zoom == 0) ? 1 : viewport->zoom;
+  if (viewport->rows != SIZE_MAX)
+  {
+    size_t height = viewport->rows * viewport->zoom * RENDER_DOT_HEIGHT[viewport->mode];
+    size_t width = viewport->columns * viewport->zoom * RENDER_DOT_WIDTH[viewport->mode];
+
+    viewport->top = (board->height <= height) ? 0 : (viewport->top > board->height - height) ?
+                    board->height - height : viewport->top;
+    viewport->left = (board->width <= width) ? 0 : (viewport->left > board->width - width) ?
+                     board->width - width : viewport->left;
+  }
+  // Without a terminal size the window still starts on the board
+  viewport->top = (viewport->top < board->height) ? viewport->top : board->height - 1;
+  viewport->left = (viewport->left < board->width) ? viewport->left : board->width - 1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Pans, zooms or switches the render mode of the viewport for a key. Pans
+/// move by a quarter of the window, zooms keep the center of the window in
+/// place.
+///
+/// @param viewport - the viewport
+/// @param board - the board
+/// @param key - the pressed key
+///
+/// @return 1 if the key moved the viewport, otherwise 0
+//
+int moveViewport(Viewport *viewport, Board *board, int key)
+{
+  size_t rows = (viewport->rows == SIZE_MAX) ? board->height : viewport->rows * RENDER_DOT_HEIGHT[viewport->mode];
+  size_t columns = (viewport->columns == SIZE_MAX) ? board->width : viewport->columns * RENDER_DOT_WIDTH[viewport->mode];
+  size_t row_step = (rows * viewport->zoom + 3) / 4;
+  size_t column_step = (columns * viewport->zoom + 3) / 4;
+  size_t center_row = viewport->top + rows * viewport->zoom / 2;
+  size_t center_column = viewport->left + columns * viewport->zoom / 2;
+
+  switch (key)
+  {
+    case 'k':
+      viewport->top -= (viewport->top < row_step) ? viewport->top : row_step;
+      break;
+    case 'j':
+      viewport->top += row_step;
+      break;
+    case 'h':
+      viewport->left -= (viewport->left < column_step) ? viewport->left : column_step;
+      break;
+    case 'l':
+      viewport->left += column_step;
+      break;
+    case 'o':
+    case 'i':
+      if ((key == 'i' && viewport->zoom == 1) || (key == 'o' && viewport->zoom >= board->height + board->width))
+      {
+        return 0;
+      }
+      viewport->zoom = (key == 'o') ? 2 * viewport->zoom : viewport->zoom / 2;
+      viewport->top = center_row - ((center_row < rows * viewport->zoom / 2) ? center_row : rows * viewport->zoom / 2);
+      viewport->left = center_column -
+                       ((center_column < columns * viewport->zoom / 2) ? center_column : columns * viewport->zoom / 2);
+      break;
+    case 'f':
+      viewport->zoom = 1;
+      while (viewport->zoom * rows < board->height || viewport->zoom * columns < board->width)
+      {
+        viewport->zoom *= 2;
+      }
+      viewport->top = 0;
+      viewport->left = 0;
+      break;
+    case 'r':
+      viewport->mode = (viewport->mode + 1) % RENDER_MODE_COUNT;
+      printf("-> Info: Rendering %s\n", RENDER_MODE_NAMES[viewport->mode]);
+      break;
+    default:
+      return 0;
+  }
+  updateViewport(viewport, board);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Seeds a xoshiro256** generator by expanding the seed with splitmix64.
+///
+/// @param random - the generator state
+/// @param seed - any 64 bit seed, equal seeds give equal sequences
+//
+void seedRandom(Random *random, uint64_t seed)
+{
+  for (size_t word = 0; word < 4; word++)
+  {
+    uint64_t value = (seed += 0x9e3779b97f4a7c15ULL);
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    random->state[word] = value ^ (value >> 31);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Draws the next value of a xoshiro256** generator.
+///
+/// @param random - the generator state
+///
+/// @return 64 uniformly distributed random bits
+//
+uint64_t nextRandom(Random *random)
+{
+  uint64_t *state = random->state;
+  uint64_t product = state[1] * 5;
+  uint64_t result = ((product << 7) | (product >> 57)) * 9;
+  uint64_t shifted = state[1] << 17;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= shifted;
+  state[3] = (state[3] << 45) | (state[3] >> 19);
+  return result;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Fills rows of the board with a random soup. Every row draws from its own
+/// generator seeded from the soup seed and the row index, so a soup does not
+/// depend on how its rows are split between workers. Each draw decides four
+/// cells against a 16 bit threshold.
+///
+/// @param board - the board
+/// @param density - the probability of a cell being alive
+/// @param seed - the seed of the soup
+/// @param first_row - the first row to fill
+/// @param last_row - the row after the last one to fill
+//
+void fillRandomRows(Board *board, double density, uint64_t seed, size_t first_row, size_t last_row)
+{
+  uint32_t threshold = (density <= 0.0) ? 0 : (density >= 1.0) ? 65536 : (uint32_t) (density * 65536.0 + 0.5);
+  size_t width = board->width;
+
+  for (size_t row = first_row; row < last_row; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    Random random;
+    size_t column = 0;
+
+    // Rows are four splitmix64 steps apart, so their states never overlap
+    seedRandom(&random, seed + 4 * row * 0x9e3779b97f4a7c15ULL);
+    for (; column + 4 <= width; column += 4)
+    {
+      uint64_t bits = nextRandom(&random);
+
+      cells[column] = (uint32_t) (bits & 0xffff) < threshold;
+      cells[column + 1] = (uint32_t) ((bits >> 16) & 0xffff) < threshold;
+      cells[column + 2] = (uint32_t) ((bits >> 32) & 0xffff) < threshold;
+      cells[column + 3] = (uint32_t) (bits >> 48) < threshold;
+    }
+    if (column < width)
+    {
+      uint64_t bits = nextRandom(&random);
+
+      for (; column < width; column++, bits >>= 16)
+      {
+        cells[column] = (uint32_t) (bits & 0xffff) < threshold;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Fills the board with a random soup on the calling thread. The activity
+/// tiles of a reused board are invalidated.
+///
+/// @param board - the board
+/// @param density - the probability of a cell being alive
+/// @param seed - the seed of the soup
+//
+void fillRandomBoard(Board *board, double density, uint64_t seed)
+{
+  fillRandomRows(board, density, seed, 0, board->height);
+  board->activity_generation = SIZE_MAX;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job filling the band of rows owned by the worker with a soup.
+///
+/// @param argument - the RandomFill
+/// @param worker - the worker index
+//
+void fillRandomBand(void *argument, size_t worker)
+{
+  RandomFill *fill = (RandomFill*) argument;
+  size_t first_row;
+  size_t last_row;
+
+  bandRows(fill->board->height, worker, &first_row, &last_row);
+  fillRandomRows(fill->board, fill->density, fill->seed, first_row, last_row);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Fills the board with a random soup using the whole worker pool. The soup
+/// is the same as the one of fillRandomBoard for any number of workers.
+///
+/// @param board - the board
+/// @param density - the probability of a cell being alive
+/// @param seed - the seed of the soup
+//
+void fillRandomBoardParallel(Board *board, double density, uint64_t seed)
+{
+  RandomFill fill = { board, density, seed };
+
+  runWorkers(fillRandomBand, &fill);
+  board->activity_generation = SIZE_MAX;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies a pattern given as rows of '.'/'#' strings into the board. Cells
+/// falling outside of the board are clipped.
+///
+/// @param board - the board
+/// @param pattern - NULL terminated list of rows
+/// @param top - the row of the upper left pattern cell
+/// @param left - the column of the upper left pattern cell
+//
+void stampPattern(Board *board, const char * const *pattern, size_t top, size_t left)
+{
+  for (size_t row = 0; pattern[row] != NULL && top + row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, top + row);
+    for (size_t column = 0; pattern[row][column] != '\0' && left + column < board->width; column++)
+    {
+      cells[left + column] = (pattern[row][column] == '#') ? CELL_ALIVE : CELL_DEAD;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Repeats the board of a config file across the whole board.
+///
+/// @param board - the board
+/// @param file_path - path to the config file used as a tile
+///
+/// @return 0 if the tile could be loaded, otherwise a value > 1
+//
+int tileConfigFile(Board *board, const char *file_path)
+{
+  Board *tile = NULL;
+  size_t tile_height;
+  size_t tile_width;
+
+  if (loadBoardFile(file_path, &tile))
+  {
+    freeBoard(tile);
+    return ERROR;
+  }
+  tile_height = tile->height;
+  tile_width = tile->width;
+
+  for (size_t row = 0; row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    uint8_t *tile_cells = boardRow(tile, tile->current, row % tile_height);
+    for (size_t column = 0; column < board->width; column++)
+    {
+      cells[column] = tile_cells[column % tile_width];
+    }
+  }
+  freeBoard(tile);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Creates the initial board of a benchmark workload.
+///
+/// @param workload - the workload description
+/// @param board - the allocated board
+///
+/// @return 0 if the board could be created, otherwise a value > 1
+//
+int createWorkloadBoard(const Workload *workload, Board **board)
+{
+  if (allocateBoard(board, workload->height, workload->width))
+  {
+    return ERROR;
+  }
+
+  switch (workload->kind)
+  {
+    case WORKLOAD_SOUP:
+      fillRandomBoard(*board, workload->density, BENCH_SEED);
+      break;
+    case WORKLOAD_TILES:
+      return tileConfigFile(*board, workload->source);
+    case WORKLOAD_PATTERN:
+    {
+      size_t pattern_height = 0;
+      while (workload->pattern[pattern_height] != NULL)
+      {
+        pattern_height++;
+      }
+      stampPattern(*board, workload->pattern, (workload->height - pattern_height) / 2,
+                   (workload->width - strlen(workload->pattern[0])) / 2);
+      break;
+    }
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Counts the live cells of the board.
+///
+/// @param board - the board
+///
+/// @return the number of live cells
+//
+size_t countPopulation(Board *board)
+{
+  size_t population = 0;
+
+  for (size_t row = 0; row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    for (size_t column = 0; column < board->width; column++)
+    {
+      population += cells[column];
+    }
+  }
+  return population;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Hashes the current generation of the board, eight cells at a time.
+///
+/// @param board - the board
+///
+/// @return the hash of the live cells
+//
+uint64_t hashBoard(Board *board)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (size_t row = 0; row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    size_t column = 0;
+
+    for (; column + sizeof(uint64_t) <= board->width; column += sizeof(uint64_t))
+    {
+      uint64_t word;
+      memcpy(&word, cells + column, sizeof(word));
+      hash = (hash ^ word) * 0x100000001b3ULL;
+      hash ^= hash >> 32;
+    }
+    for (; column < board->width; column++)
+    {
+      hash = (hash ^ cells[column]) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ row) * 0x9e3779b97f4a7c15ULL;
+  }
+  return hash;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances a board on the calling thread until it stabilizes or a
+/// generation limit is reached. The board is compared against a snapshot
+/// taken at every power of two generation, so a cycle of period p entered
+/// by generation g is detected by generation 2 * max(g, p).
+///
+/// @param board - the board
+/// @param max_generations - the generation limit
+/// @param period - receives the period of the final state (1 for still lifes
+///                 and empty boards), 0 if the limit was reached first
+///
+/// @return the number of generations advanced
+//
+size_t runToStabilization(Board *board, size_t max_generations, size_t *period)
+{
+  size_t height = board->height;
+  size_t width = board->width;
+  uint8_t *snapshot = (uint8_t*) malloc(height * width);
+  size_t snapshot_generation = 0;
+  size_t generation;
+
+  if (snapshot == NULL)
+  {
+    printf("-> Error: Out of memory in stabilization run!\n");
+    exit(ERROR);
+  }
+  *period = 0;
+  for (size_t row = 0; row < height; row++)
+  {
+    memcpy(snapshot + row * width, boardRow(board, board->current, row), width);
+  }
+  for (generation = 1; generation <= max_generations; generation++)
+  {
+    size_t row = 0;
+
+    updateBoardRows(board);
+    while (row < height && !memcmp(snapshot + row * width, boardRow(board, board->current, row), width))
+    {
+      row++;
+    }
+    if (row == height)
+    {
+      *period = generation - snapshot_generation;
+      break;
+    }
+    if ((generation & (generation - 1)) == 0)
+    {
+      for (row = 0; row < height; row++)
+      {
+        memcpy(snapshot + row * width, boardRow(board, board->current, row), width);
+      }
+      snapshot_generation = generation;
+    }
+  }
+  free(snapshot);
+  if (generation > max_generations)
+  {
+    generation = max_generations;
+  }
+  board->generation += generation;
+  return generation;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Allocates a batch of SLICED_LANES boards with dead cells.
+///
+/// @param batch - receives the batch
+/// @param board_height - the height of every board
+/// @param board_width - the width of every board
+///
+/// @return 0 if the batch could be allocated, otherwise a value > 1
+//
+int allocateSlicedBatch(SlicedBatch **batch, size_t board_height, size_t board_width)
+{
+  size_t plane_size;
+
+  *batch = NULL;
+  if (board_height == 0 || board_width == 0 || board_width > SIZE_MAX / 4 ||
+      board_height > SIZE_MAX / 4 / sizeof(uint64_t) / (board_width + 2))
+  {
+    printf("-> Error: Invalid board size!\n");
+    return ERROR;
+  }
+  plane_size = (board_height + 2) * (board_width + 2);
+  *batch = (SlicedBatch*) calloc(1, sizeof(SlicedBatch));
+  if (*batch == NULL)
+  {
+    return ERROR;
+  }
+  (*batch)->current = (uint64_t*) calloc(3 * plane_size, sizeof(uint64_t));
+  if ((*batch)->current == NULL)
+  {
+    free(*batch);
+    *batch = NULL;
+    return ERROR;
+  }
+  (*batch)->height = board_height;
+  (*batch)->width = board_width;
+  (*batch)->stride = board_width + 2;
+  (*batch)->topology = TOPOLOGY_BOUNDED;
+  (*batch)->next = (*batch)->current + plane_size;
+  (*batch)->snapshot = (*batch)->next + plane_size;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Frees a batch allocated with allocateSlicedBatch.
+///
+/// @param batch - the batch, may be NULL
+//
+void freeSlicedBatch(SlicedBatch *batch)
+{
+  if (batch == NULL)
+  {
+    return;
+  }
+  // The planes share one allocation, it starts with whichever came first
+  free((batch->current < batch->next) ? batch->current : batch->next);
+  free(batch);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies the current generation of a board into one lane of a batch.
+///
+/// @param batch - the batch
+/// @param lane - the lane, 0 to SLICED_LANES - 1
+/// @param board - the board, of the size of the batch
+//
+void packSlicedBoard(SlicedBatch *batch, size_t lane, Board *board)
+{
+  uint64_t mask = (uint64_t) 1 << lane;
+
+  for (size_t row = 0; row < batch->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    uint64_t *words = batch->current + (row + 1) * batch->stride + 1;
+
+    for (size_t column = 0; column < batch->width; column++)
+    {
+      words[column] = (words[column] & ~mask) | ((uint64_t) cells[column] << lane);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Counts the live cells of one lane of a batch.
+///
+/// @param batch - the batch
+/// @param lane - the lane
+///
+/// @return the population of the lane
+//
+size_t countSlicedPopulation(SlicedBatch *batch, size_t lane)
+{
+  size_t population = 0;
+
+  for (size_t row = 0; row < batch->height; row++)
+  {
+    uint64_t *words = batch->current + (row + 1) * batch->stride + 1;
+
+    for (size_t column = 0; column < batch->width; column++)
+    {
+      population += (words[column] >> lane) & 1;
+    }
+  }
+  return population;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Updates all the boards of a batch for the next step. Every word holds one
+/// cell of each board, so the neighbour counts of all boards are summed at
+/// once with a bitwise adder: ones, twos and fours are the bits of the count,
+/// which wraps eight to zero as both are fatal anyway.
+///
+/// @param batch - the batch
+//
+void updateSlicedBatch(SlicedBatch *batch)
+{
+  Neighbour neighbour[8] = { {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1} };
+  size_t stride = batch->stride;
+  size_t width = batch->width;
+  ptrdiff_t offset[8];
+  uint64_t *swap;
+
+  for (size_t count = 0; count < 8; count++)
+  {
+    offset[count] = neighbour[count].offset_y * (ptrdiff_t) stride + neighbour[count].offset_x;
+  }
+  if (batch->topology == TOPOLOGY_TORUS)
+  {
+    for (size_t row = 1; row <= batch->height; row++)
+    {
+      batch->current[row * stride] = batch->current[row * stride + width];
+      batch->current[row * stride + width + 1] = batch->current[row * stride + 1];
+    }
+    memcpy(batch->current, batch->current + batch->height * stride, stride * sizeof(uint64_t));
+    memcpy(batch->current + (batch->height + 1) * stride, batch->current + stride, stride * sizeof(uint64_t));
+  }
+
+  for (size_t row = 1; row <= batch->height; row++)
+  {
+    const uint64_t *cells = batch->current + row * stride + 1;
+    uint64_t *new_cells = batch->next + row * stride + 1;
+
+    for (size_t column = 0; column < width; column++)
+    {
+      uint64_t ones = 0;
+      uint64_t twos = 0;
+      uint64_t fours = 0;
+
+      for (size_t count = 0; count < 8; count++)
+      {
+        uint64_t cell = cells[(ptrdiff_t) column + offset[count]];
+        uint64_t carry = ones & cell;
+
+        ones ^= cell;
+        fours ^= twos & carry;
+        twos ^= carry;
+      }
+      // Two or three neighbours keep a live cell, exactly three bear one
+      new_cells[column] = twos & ~fours & (ones | cells[column]);
+    }
+  }
+
+  swap = batch->current;
+  batch->current = batch->next;
+  batch->next = swap;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies the current generation of a batch into its snapshot.
+///
+/// @param batch - the batch
+//
+void takeSlicedSnapshot(SlicedBatch *batch)
+{
+  for (size_t row = 1; row <= batch->height; row++)
+  {
+    memcpy(batch->snapshot + row * batch->stride + 1, batch->current + row * batch->stride + 1,
+           batch->width * sizeof(uint64_t));
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances all lanes of a batch until each one stabilizes or the generation
+/// limit is reached, with the same power of two snapshots as
+/// runToStabilization, so every lane reports what it would on its own.
+///
+/// @param batch - the batch
+/// @param lanes - mask of the lanes in use
+/// @param max_generations - the generation limit
+/// @param results - receives generations, period and population per lane
+//
+void runSlicedToStabilization(SlicedBatch *batch, uint64_t lanes, size_t max_generations,
+                              EnsembleResult *results)
+{
+  uint64_t active = lanes;
+  size_t snapshot_generation = 0;
+
+  takeSlicedSnapshot(batch);
+  for (size_t generation = 1; generation <= max_generations && active != 0; generation++)
+  {
+    uint64_t changed = 0;
+    uint64_t stable;
+
+    updateSlicedBatch(batch);
+    for (size_t row = 1; row <= batch->height; row++)
+    {
+      uint64_t *words = batch->current + row * batch->stride + 1;
+      uint64_t *snapshot = batch->snapshot + row * batch->stride + 1;
+
+      for (size_t column = 0; column < batch->width; column++)
+      {
+        changed |= words[column] ^ snapshot[column];
+      }
+    }
+
+    stable = active & ~changed;
+    for (size_t lane = 0; lane < SLICED_LANES; lane++)
+    {
+      if ((stable >> lane) & 1)
+      {
+        results[lane].generations = generation;
+        results[lane].period = generation - snapshot_generation;
+        results[lane].population = countSlicedPopulation(batch, lane);
+      }
+    }
+    active &= changed;
+    if ((generation & (generation - 1)) == 0)
+    {
+      takeSlicedSnapshot(batch);
+      snapshot_generation = generation;
+    }
+  }
+
+  for (size_t lane = 0; lane < SLICED_LANES; lane++)
+  {
+    if ((active >> lane) & 1)
+    {
+      results[lane].generations = max_generations;
+      results[lane].period = 0;
+      results[lane].population = countSlicedPopulation(batch, lane);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies one lane of a batch into the current generation of a board.
+///
+/// @param batch - the batch
+/// @param lane - the lane
+/// @param board - the board, of the size of the batch
+//
+void unpackSlicedBoard(SlicedBatch *batch, size_t lane, Board *board)
+{
+  for (size_t row = 0; row < batch->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    uint64_t *words = batch->current + (row + 1) * batch->stride + 1;
+
+    for (size_t column = 0; column < batch->width; column++)
+    {
+      cells[column] = (words[column] >> lane) & 1;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Finds the root of a run, halving the path on the way.
+///
+/// @param runs - the runs
+/// @param run - the run
+///
+/// @return the root run
+//
+static inline size_t findRun(CellRun *runs, size_t run)
+{
+  while (runs[run].parent != run)
+  {
+    runs[run].parent = runs[runs[run].parent].parent;
+    run = runs[run].parent;
+  }
+  return run;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Joins the objects of two runs. The lower root wins, so every object is
+/// rooted at its first run in row order.
+///
+/// @param runs - the runs
+/// @param first - a run
+/// @param second - another run
+//
+static inline void joinRuns(CellRun *runs, size_t first, size_t second)
+{
+  first = findRun(runs, first);
+  second = findRun(runs, second);
+  if (first < second)
+  {
+    runs[second].parent = first;
+  }
+  else if (second < first)
+  {
+    runs[first].parent = second;
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Grows the per run arrays of an object list.
+///
+/// @param list - the list
+/// @param capacity - the number of runs needed
+///
+/// @return 0 if the arrays could be grown, otherwise a value > 1
+//
+int growObjectList(ObjectList *list, size_t capacity)
+{
+  void *grown;
+
+  if (capacity <= list->run_capacity)
+  {
+    return OK;
+  }
+  capacity = (capacity < 2 * list->run_capacity) ? 2 * list->run_capacity : capacity;
+  if ((grown = realloc(list->runs, capacity * sizeof(CellRun))) == NULL)
+  {
+    return ERROR;
+  }
+  list->runs = (CellRun*) grown;
+  if ((grown = realloc(list->order, capacity * sizeof(size_t))) == NULL)
+  {
+    return ERROR;
+  }
+  list->order = (size_t*) grown;
+  if ((grown = realloc(list->object_of, capacity * sizeof(size_t))) == NULL)
+  {
+    return ERROR;
+  }
+  list->object_of = (size_t*) grown;
+  if ((grown = realloc(list->merge, capacity)) == NULL)
+  {
+    return ERROR;
+  }
+  list->merge = (uint8_t*) grown;
+  if ((grown = realloc(list->objects, capacity * sizeof(BoardObject))) == NULL)
+  {
+    return ERROR;
+  }
+  list->objects = (BoardObject*) grown;
+  list->run_capacity = capacity;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Frees the arrays of an object list.
+///
+/// @param list - the list
+//
+void freeObjectList(ObjectList *list)
+{
+  free(list->runs);
+  free(list->row_runs);
+  free(list->order);
+  free(list->object_of);
+  free(list->merge);
+  free(list->objects);
+  memset(list, 0, sizeof(ObjectList));
+}
+
+//------------------------------------------------------------------------------
+///
+/// Collects the runs of live cells of the current generation and joins runs
+/// of neighbouring rows that touch, including diagonally, into objects.
+/// Empty stretches are skipped eight cells at a time. Cells beyond the edges
+/// do not connect, even on torus boards.
+///
+/// @param board - the board
+/// @param list - receives the runs, reusing its arrays
+///
+/// @return 0 if the runs could be collected, otherwise a value > 1
+//
+int collectRuns(Board *board, ObjectList *list)
+{
+  size_t width = board->width;
+
+  if (board->height + 1 > list->row_capacity)
+  {
+    size_t *grown = (size_t*) realloc(list->row_runs, (board->height + 1) * sizeof(size_t));
+    if (grown == NULL)
+    {
+      return ERROR;
+    }
+    list->row_runs = grown;
+    list->row_capacity = board->height + 1;
+  }
+  list->height = board->height;
+  list->run_count = 0;
+  list->object_count = 0;
+
+  for (size_t row = 0; row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    size_t column = 0;
+
+    list->row_runs[row] = list->run_count;
+    while (column < width)
+    {
+      uint64_t word;
+      size_t start;
+
+      if (column + sizeof(word) <= width)
+      {
+        memcpy(&word, cells + column, sizeof(word));
+        if (word == 0)
+        {
+          column += sizeof(word);
+          continue;
+        }
+      }
+      if (cells[column] == CELL_DEAD)
+      {
+        column++;
+        continue;
+      }
+      start = column;
+      while (column < width && cells[column] == CELL_ALIVE)
+      {
+        column++;
+      }
+      if (growObjectList(list, list->run_count + 1))
+      {
+        return ERROR;
+      }
+      list->runs[list->run_count] = (CellRun) { row, start, column, list->run_count };
+      list->run_count++;
+    }
+  }
+  list->row_runs[board->height] = list->run_count;
+
+  for (size_t row = 1; row < board->height; row++)
+  {
+    size_t above = list->row_runs[row - 1];
+    size_t current = list->row_runs[row];
+
+    while (above < list->row_runs[row] && current < list->row_runs[row + 1])
+    {
+      CellRun *upper = &list->runs[above];
+      CellRun *lower = &list->runs[current];
+
+      if (upper->end < lower->start)
+      {
+        above++;
+      }
+      else if (lower->end < upper->start)
+      {
+        current++;
+      }
+      else
+      {
+        joinRuns(list->runs, above, current);
+        (upper->end < lower->end) ? above++ : current++;
+      }
+    }
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Joins the runs of every object marked in list->merge with all runs
+/// within two cells, the range over which separate objects can still
+/// influence each other.
+///
+/// @param list - the list with grouped objects
+//
+void joinNearbyRuns(ObjectList *list)
+{
+  for (size_t object = 0; object < list->object_count; object++)
+  {
+    BoardObject *marked = &list->objects[object];
+
+    if (!list->merge[object])
+    {
+      continue;
+    }
+    for (size_t index = 0; index < marked->run_count; index++)
+    {
+      size_t run = list->order[marked->first_run + index];
+      CellRun *cells = &list->runs[run];
+      size_t first_row = (cells->row < 2) ? 0 : cells->row - 2;
+      size_t last_row = (cells->row + 3 < list->height) ? cells->row + 3 : list->height;
+
+      for (size_t other = list->row_runs[first_row]; other < list->row_runs[last_row]; other++)
+      {
+        if (list->runs[other].start <= cells->end + 1 && list->runs[other].end + 1 >= cells->start)
+        {
+          joinRuns(list->runs, run, other);
+        }
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Groups the runs into objects by their roots. Objects are numbered in the
+/// order of their first run.
+///
+/// @param list - the list with joined runs
+//
+void groupObjects(ObjectList *list)
+{
+  CellRun *runs = list->runs;
+  size_t first_run = 0;
+
+  list->object_count = 0;
+  for (size_t run = 0; run < list->run_count; run++)
+  {
+    size_t root = findRun(runs, run);
+
+    if (root == run)
+    {
+      list->object_of[run] = list->object_count;
+      list->objects[list->object_count] = (BoardObject) { runs[run].row, runs[run].start, 0, 0, 0, 0, 0 };
+      list->object_count++;
+    }
+    else
+    {
+      BoardObject *object = &list->objects[list->object_of[root]];
+
+      object->left = (runs[run].start < object->left) ? runs[run].start : object->left;
+    }
+  }
+  for (size_t run = 0; run < list->run_count; run++)
+  {
+    BoardObject *object = &list->objects[list->object_of[findRun(runs, run)]];
+
+    object->height = runs[run].row + 1 - object->top;
+    if (runs[run].end - object->left > object->width)
+    {
+      object->width = runs[run].end - object->left;
+    }
+    object->population += runs[run].end - runs[run].start;
+    object->run_count++;
+  }
+  for (size_t object = 0; object < list->object_count; object++)
+  {
+    list->objects[object].first_run = first_run;
+    first_run += list->objects[object].run_count;
+    list->objects[object].run_count = 0;
+  }
+  for (size_t run = 0; run < list->run_count; run++)
+  {
+    BoardObject *object = &list->objects[list->object_of[runs[run].parent]];
+
+    list->order[object->first_run + object->run_count++] = run;
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Finds the objects of the current generation, live cells connected
+/// horizontally, vertically or diagonally.
+///
+/// @param board - the board
+/// @param list - receives the objects, reusing its arrays
+///
+/// @return 0 if the objects could be found, otherwise a value > 1
+//
+int findObjects(Board *board, ObjectList *list)
+{
+  if (collectRuns(board, list))
+  {
+    return ERROR;
+  }
+  groupObjects(list);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Crops an object out of its runs.
+///
+/// @param list - the list
+/// @param object - the object
+/// @param shape - receives the allocated shape
+///
+/// @return 0 if the shape could be allocated, otherwise a value > 1
+//
+int extractShape(ObjectList *list, BoardObject *object, Shape *shape)
+{
+  shape->height = object->height;
+  shape->width = object->width;
+  shape->cells = (uint8_t*) calloc(object->height * object->width, 1);
+  if (shape->cells == NULL)
+  {
+    return ERROR;
+  }
+  for (size_t index = 0; index < object->run_count; index++)
+  {
+    CellRun *run = &list->runs[list->order[object->first_run + index]];
+
+    memset(shape->cells + (run->row - object->top) * object->width + run->start - object->left, CELL_ALIVE,
+           run->end - run->start);
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Crops the live cells of the current generation of a board.
+///
+/// @param board - the board
+/// @param shape - receives the allocated shape
+/// @param top - receives the row of the upper left corner
+/// @param left - receives the column of the upper left corner
+///
+/// @return 0 if there were live cells, none of them on the edge of the board,
+///         otherwise a value > 1
+//
+int cropBoard(Board *board, Shape *shape, size_t *top, size_t *left)
+{
+  size_t bottom = 0;
+  size_t right = 0;
+
+  *top = SIZE_MAX;
+  *left = SIZE_MAX;
+  for (size_t row = 0; row < board->height; row++)
+  {
+    uint8_t *cells = boardRow(board, board->current, row);
+    for (size_t column = 0; column < board->width; column++)
+    {
+      if (cells[column] == CELL_ALIVE)
+      {
+        *top = (*top == SIZE_MAX) ? row : *top;
+        bottom = row;
+        *left = (column < *left) ? column : *left;
+        right = (column > right) ? column : right;
+      }
+    }
+  }
+  if (*top == SIZE_MAX || *top == 0 || *left == 0 || bottom + 1 == board->height || right + 1 == board->width)
+  {
+    return ERROR;
+  }
+
+  shape->height = bottom + 1 - *top;
+  shape->width = right + 1 - *left;
+  shape->cells = (uint8_t*) malloc(shape->height * shape->width);
+  if (shape->cells == NULL)
+  {
+    return ERROR;
+  }
+  for (size_t row = 0; row < shape->height; row++)
+  {
+    memcpy(shape->cells + row * shape->width, boardRow(board, board->current, *top + row) + *left, shape->width);
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads a cell of a shape in one of its 8 orientations. Bit 0 of the
+/// symmetry flips rows, bit 1 flips columns and bit 2 transposes.
+///
+/// @param shape - the shape
+/// @param symmetry - the orientation, 0 to 7
+/// @param row - the row in the oriented shape
+/// @param column - the column in the oriented shape
+///
+/// @return the cell
+//
+static inline uint8_t orientedCell(const Shape *shape, int symmetry, size_t row, size_t column)
+{
+  size_t height = (symmetry & 4) ? shape->width : shape->height;
+  size_t width = (symmetry & 4) ? shape->height : shape->width;
+
+  row = (symmetry & 1) ? height - 1 - row : row;
+  column = (symmetry & 2) ? width - 1 - column : column;
+  return (symmetry & 4) ? shape->cells[column * shape->width + row] : shape->cells[row * shape->width + column];
+}
+
+//------------------------------------------------------------------------------
+///
+/// Encodes an oriented shape in extended Wechsler format: strips of 5 rows,
+/// one base 32 digit per column of a strip, strips separated by 'z' and runs
+/// of empty columns shortened to '0', 'w', 'x' or 'y' and a count.
+///
+/// @param shape - the shape
+/// @param symmetry - the orientation, see orientedCell
+/// @param code - receives the code, see wechslerLength for the size
+///
+/// @return the length of the code
+//
+size_t encodeWechsler(const Shape *shape, int symmetry, char *code)
+{
+  static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+  size_t height = (symmetry & 4) ? shape->width : shape->height;
+  size_t width = (symmetry & 4) ? shape->height : shape->width;
+  size_t length = 0;
+
+  for (size_t strip = 0; strip < height; strip += 5)
+  {
+    size_t zeroes = 0;
+
+    if (strip > 0)
+    {
+      code[length++] = 'z';
+    }
+    for (size_t column = 0; column < width; column++)
+    {
+      unsigned value = 0;
+
+      for (size_t bit = 0; bit < 5 && strip + bit < height; bit++)
+      {
+        value |= (unsigned) orientedCell(shape, symmetry, strip + bit, column) << bit;
+      }
+      if (value == 0)
+      {
+        zeroes++;
+        continue;
+      }
+      for (; zeroes > 39; zeroes -= 39)
+      {
+        code[length++] = 'y';
+        code[length++] = 'z';
+      }
+      if (zeroes >= 4)
+      {
+        code[length++] = 'y';
+        code[length++] = DIGITS[zeroes - 4];
+      }
+      else if (zeroes > 0)
+      {
+        code[length++] = "0wx"[zeroes - 1];
+      }
+      zeroes = 0;
+      code[length++] = DIGITS[value];
+    }
+  }
+  code[length] = '\0';
+  return length;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Upper bound of the length of the Wechsler code of a shape.
+///
+/// @param shape - the shape
+///
+/// @return the size of a buffer large enough for any orientation
+//
+size_t wechslerLength(const Shape *shape)
+{
+  size_t side = (shape->height > shape->width) ? shape->height : shape->width;
+
+  return (side / 5 + 1) * (2 * side + 1) + 1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Simulates a shape on its own until it reappears, possibly moved, and
+/// names it with its apgcode: a prefix for still lifes ("xs" and the
+/// population), oscillators ("xp" and the period) or spaceships ("xq" and
+/// the period), then the shortest, lexicographically first Wechsler code of
+/// all phases and orientations. Shapes that die, grow beyond the simulated
+/// area or do not reappear within CLASSIFY_MAX_PERIOD generations are
+/// unknown.
+///
+/// @param shape - the shape, owned by the caller
+/// @param classification - receives the classification and an allocated code
+///
+/// @return 0 if the shape could be classified, otherwise a value > 1
+//
+int classifyShape(const Shape *shape, Classification *classification)
+{
+  size_t max_margin = CLASSIFY_MAX_PERIOD / 2 + 2;
+  size_t margin = CLASSIFY_MIN_MARGIN;
+  Shape phases[CLASSIFY_MAX_PERIOD];
+  size_t phase_count = 1;
+  size_t population = 0;
+  Board *board = NULL;
+  int grow = 1;
+  char *candidate;
+
+  classification->kind = OBJECT_UNKNOWN;
+  classification->period = 0;
+  classification->offset_y = 0;
+  classification->offset_x = 0;
+  classification->code = NULL;
+  for (size_t cell = 0; cell < shape->height * shape->width; cell++)
+  {
+    population += shape->cells[cell];
+  }
+  phases[0] = *shape;
+
+  // Most shapes settle or die where they are, so the simulated area starts
+  // small and is only enlarged for shapes that reach its edge
+  while (grow)
+  {
+    grow = 0;
+    if (allocateBoard(&board, shape->height + 2 * margin, shape->width + 2 * margin))
+    {
+      return ERROR;
+    }
+    for (size_t row = 0; row < shape->height; row++)
+    {
+      memcpy(boardRow(board, board->current, margin + row) + margin, shape->cells + row * shape->width,
+             shape->width);
+    }
+    for (size_t generation = 1; generation <= CLASSIFY_MAX_PERIOD; generation++)
+    {
+      Shape current;
+      size_t top;
+      size_t left;
+
+      updateBoardRows(board);
+      if (cropBoard(board, &current, &top, &left))
+      {
+        grow = (margin < max_margin && countPopulation(board) != 0);
+        break;
+      }
+      if (current.height == shape->height && current.width == shape->width &&
+          !memcmp(current.cells, shape->cells, shape->height * shape->width))
+      {
+        free(current.cells);
+        classification->period = generation;
+        classification->offset_y = (ptrdiff_t) top - (ptrdiff_t) margin;
+        classification->offset_x = (ptrdiff_t) left - (ptrdiff_t) margin;
+        classification->kind = (classification->offset_y || classification->offset_x) ? OBJECT_SPACESHIP :
+                               (generation == 1) ? OBJECT_STILL_LIFE : OBJECT_OSCILLATOR;
+        break;
+      }
+      if (phase_count == CLASSIFY_MAX_PERIOD)
+      {
+        free(current.cells);
+        break;
+      }
+      phases[phase_count++] = current;
+    }
+    freeBoard(board);
+    if (grow)
+    {
+      for (; phase_count > 1; phase_count--)
+      {
+        free(phases[phase_count - 1].cells);
+      }
+      margin = (2 * margin < max_margin) ? 2 * margin : max_margin;
+    }
+  }
+
+  if (classification->kind == OBJECT_UNKNOWN)
+  {
+    classification->code = strdup("zz_unknown");
+  }
+  else
+  {
+    size_t best_length = SIZE_MAX;
+    size_t prefix;
+    size_t size = 0;
+
+    for (size_t phase = 0; phase < classification->period; phase++)
+    {
+      size = (wechslerLength(&phases[phase]) > size) ? wechslerLength(&phases[phase]) : size;
+    }
+    classification->code = (char*) malloc(size + 32);
+    candidate = (char*) malloc(size);
+    if (classification->code != NULL && candidate != NULL)
+    {
+      prefix = (size_t) sprintf(classification->code, "x%c%zu_", "?spq"[classification->kind],
+                                (classification->kind == OBJECT_STILL_LIFE) ? population : classification->period);
+      for (size_t phase = 0; phase < classification->period; phase++)
+      {
+        for (int symmetry = 0; symmetry < 8; symmetry++)
+        {
+          size_t length = encodeWechsler(&phases[phase], symmetry, candidate);
+
+          if (length < best_length || (length == best_length && strcmp(candidate, classification->code + prefix) < 0))
+          {
+            best_length = length;
+            memcpy(classification->code + prefix, candidate, length + 1);
+          }
+        }
+      }
+    }
+    free(candidate);
+  }
+  for (size_t phase = 1; phase < phase_count; phase++)
+  {
+    free(phases[phase].cells);
+  }
+  return (classification->code == NULL) ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Hashes a shape.
+///
+/// @param shape - the shape
+///
+/// @return the hash of its size and cells
+//
+uint64_t hashShape(const Shape *shape)
+{
+  uint64_t hash = (0xcbf29ce484222325ULL ^ shape->height) * 0x100000001b3ULL;
+
+  hash = (hash ^ shape->width) * 0x100000001b3ULL;
+  for (size_t cell = 0; cell < shape->height * shape->width; cell++)
+  {
+    hash = (hash ^ shape->cells[cell]) * 0x100000001b3ULL;
+  }
+  return hash ^ (hash >> 29);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Classifies an object, simulating each distinct shape only once. Ash is
+/// made of a handful of common objects, so almost every lookup hits.
+///
+/// @param cache - the cache of classified shapes
+/// @param list - the list
+/// @param object - the object
+///
+/// @return the classification, owned by the cache
+//
+const Classification *classifyObject(ShapeCache *cache, ObjectList *list, BoardObject *object)
+{
+  Classification *entry;
+  Shape shape;
+  uint64_t hash;
+  size_t slot;
+
+  if (cache->count * 2 >= cache->capacity)
+  {
+    size_t capacity = cache->capacity ? 2 * cache->capacity : SHAPE_CACHE_SIZE;
+    Classification **entries = (Classification**) calloc(capacity, sizeof(Classification*));
+
+    if (entries == NULL)
+    {
+      printf("-> Error: Out of memory in object classification!\n");
+      exit(ERROR);
+    }
+    for (size_t old = 0; old < cache->capacity; old++)
+    {
+      if (cache->entries[old] != NULL)
+      {
+        for (slot = cache->entries[old]->hash & (capacity - 1); entries[slot] != NULL;
+             slot = (slot + 1) & (capacity - 1));
+        entries[slot] = cache->entries[old];
+      }
+    }
+    free(cache->entries);
+    cache->entries = entries;
+    cache->capacity = capacity;
+  }
+
+  if (extractShape(list, object, &shape))
+  {
+    printf("-> Error: Out of memory in object classification!\n");
+    exit(ERROR);
+  }
+  hash = hashShape(&shape);
+  for (slot = hash & (cache->capacity - 1); cache->entries[slot] != NULL; slot = (slot + 1) & (cache->capacity - 1))
+  {
+    entry = cache->entries[slot];
+    if (entry->hash == hash && entry->shape.height == shape.height && entry->shape.width == shape.width &&
+        !memcmp(entry->shape.cells, shape.cells, shape.height * shape.width))
+    {
+      free(shape.cells);
+      return entry;
+    }
+  }
+
+  entry = (Classification*) malloc(sizeof(Classification));
+  if (entry == NULL || classifyShape(&shape, entry))
+  {
+    printf("-> Error: Out of memory in object classification!\n");
+    exit(ERROR);
+  }
+  entry->hash = hash;
+  entry->shape = shape;
+  cache->entries[slot] = entry;
+  cache->count++;
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Frees a shape cache with all of its shapes and codes.
+///
+/// @param cache - the cache
+//
+void freeShapeCache(ShapeCache *cache)
+{
+  for (size_t slot = 0; slot < cache->capacity; slot++)
+  {
+    if (cache->entries[slot] != NULL)
+    {
+      free(cache->entries[slot]->shape.cells);
+      free(cache->entries[slot]->code);
+      free(cache->entries[slot]);
+    }
+  }
+  free(cache->entries);
+  memset(cache, 0, sizeof(ShapeCache));
+}
+
+//------------------------------------------------------------------------------
+///
+/// Opens one disabled hardware counter per event for each of the first
+/// threads of the worker pool, so the work of the pool threads is counted
+/// along with the calling thread. Events the kernel refuses on any of the
+/// threads (no PMU, paranoid setting, VM) are left at -1 and reported as
+/// "n/a" while the remaining ones are still counted.
+///
+/// @param counters - the counter set to open
+/// @param name - the name printed in the report
+/// @param threads - the number of pool workers to count, at least 1
+///
+/// @return 0 if at least one counter could be opened, otherwise a value > 1
+//
+int openPerfCounters(PerfCounters *counters, const char *name, size_t threads)
+{
+  int opened = 0;
+
+  memset(counters, 0, sizeof(*counters));
+  counters->name = name;
+  counters->threads = (threads < worker_pool.size) ? threads : worker_pool.size;
+  for (size_t event = 0; event < PERF_EVENT_COUNT; event++)
+  {
+    struct perf_event_attr attr;
+    size_t worker;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_EVENT_CONFIG[event];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    for (worker = 0; worker < counters->threads; worker++)
+    {
+      counters->fd[worker][event] = (int) syscall(SYS_perf_event_open, &attr, worker_pool.thread_ids[worker], -1,
+                                                  -1, 0);
+      if (counters->fd[worker][event] < 0)
+      {
+        break;
+      }
+    }
+    if (worker == counters->threads)
+    {
+      opened++;
+      continue;
+    }
+    // A partly counted pool would understate the event
+    while (worker-- > 0)
+    {
+      close(counters->fd[worker][event]);
+      counters->fd[worker][event] = -1;
+    }
+  }
+
+  if (opened == 0)
+  {
+    printf(INFO_NO_COUNTERS, name, strerror(errno));
+    return ERROR;
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Starts counting a measured section.
+///
+/// @param counters - the counter set to enable
+//
+void startPerfCounters(PerfCounters *counters)
+{
+  clock_gettime(CLOCK_MONOTONIC, &counters->start);
+  for (size_t worker = 0; worker < counters->threads; worker++)
+  {
+    for (size_t event = 0; event < PERF_EVENT_COUNT; event++)
+    {
+      if (counters->fd[worker][event] >= 0)
+      {
+        ioctl(counters->fd[worker][event], PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Stops counting a measured section and books it.
+///
+/// @param counters - the counter set to disable
+/// @param cells - the number of cells processed in the section
+//
+void stopPerfCounters(PerfCounters *counters, size_t cells)
+{
+  struct timespec stop;
+
+  for (size_t worker = 0; worker < counters->threads; worker++)
+  {
+    for (size_t event = 0; event < PERF_EVENT_COUNT; event++)
+    {
+      if (counters->fd[worker][event] >= 0)
+      {
+        ioctl(counters->fd[worker][event], PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  counters->seconds += (stop.tv_sec - counters->start.tv_sec) + (stop.tv_nsec - counters->start.tv_nsec) / 1e9;
+  counters->calls++;
+  counters->cells += cells;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads the accumulated counter values of all threads and closes the
+/// counters. Values are scaled up if the kernel had to multiplex the PMU
+/// between events. Threads that never ran while counting add nothing.
+///
+/// @param counters - the counter set to close
+//
+void closePerfCounters(PerfCounters *counters)
+{
+  for (size_t event = 0; event < PERF_EVENT_COUNT; event++)
+  {
+    int counted = 0;
+    int failed = 0;
+
+    for (size_t worker = 0; worker < counters->threads; worker++)
+    {
+      uint64_t data[3] = { 0, 0, 0 };
+
+      if (counters->fd[worker][event] < 0)
+      {
+        continue;
+      }
+      if (read(counters->fd[worker][event], data, sizeof(data)) != sizeof(data))
+      {
+        failed = 1;
+      }
+      else if (data[2] > 0)
+      {
+        counted = 1;
+        counters->value[event] += (data[2] < data[1]) ? (uint64_t) ((double) data[0] * data[1] / data[2]) : data[0];
+      }
+      close(counters->fd[worker][event]);
+    }
+    if (failed || !counted)
+    {
+      counters->fd[0][event] = -1;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Prints the derived metrics of a closed counter set. Metrics whose inputs
+/// were not available are printed as "n/a".
+///
+/// @param counters - the closed counter set
+//
+void printPerfCounters(PerfCounters *counters)
+{
+  const uint64_t *value = counters->value;
+  const int *fd = counters->fd[0];
+
+  printf("-> Perf: %s (%zu calls, %zu cells, %.3f s)\n", counters->name, counters->calls, counters->cells,
+         counters->seconds);
+  if (counters->cells > 0)
+  {
+    printf("   nanoseconds per cell:    %.3f\n", counters->seconds * 1e9 / counters->cells);
+  }
+  if (fd[PERF_CYCLES] >= 0 && fd[PERF_INSTRUCTIONS] >= 0 && value[PERF_CYCLES] > 0)
+  {
+    printf("   instructions per cycle:  %.3f\n", (double) value[PERF_INSTRUCTIONS] / value[PERF_CYCLES]);
+  }
+  else
+  {
+    printf("   instructions per cycle:  n/a\n");
+  }
+  if (fd[PERF_CYCLES] >= 0 && counters->cells > 0)
+  {
+    printf("   cycles per cell update:  %.3f\n", (double) value[PERF_CYCLES] / counters->cells);
+  }
+  else
+  {
+    printf("   cycles per cell update:  n/a\n");
+  }
+  if (fd[PERF_CACHE_MISSES] >= 0 && fd[PERF_CACHE_REFERENCES] >= 0 && value[PERF_CACHE_REFERENCES] > 0)
+  {
+    printf("   cache misses:            %" PRIu64 " (%.2f%% of references)\n", value[PERF_CACHE_MISSES],
+           100.0 * value[PERF_CACHE_MISSES] / value[PERF_CACHE_REFERENCES]);
+  }
+  else
+  {
+    printf("   cache misses:            n/a\n");
+  }
+  if (fd[PERF_BRANCH_MISSES] >= 0 && fd[PERF_BRANCHES] >= 0 && value[PERF_BRANCHES] > 0)
+  {
+    printf("   branch mispredictions:   %" PRIu64 " (%.2f%% of branches)\n", value[PERF_BRANCH_MISSES],
+           100.0 * value[PERF_BRANCH_MISSES] / value[PERF_BRANCHES]);
+  }
+  else
+  {
+    printf("   branch mispredictions:   n/a\n");
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Stops the simulation loop on Ctrl-C so the run can be reported.
+///
+/// @param signal_number - the received signal
+//
+void handleInterrupt(int signal_number)
+{
+  (void) signal_number;
+  keep_running = 0;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Notes a change of the terminal size, the next frame fits the viewport
+/// to it.
+///
+/// @param signal_number - the received signal
+//
+void handleResize(int signal_number)
+{
+  (void) signal_number;
+  terminal_resized = 1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Restores the settings of the terminal changed by openTerminal.
+//
+void restoreTerminal(void)
+{
+  if (terminal.raw)
+  {
+    tcsetattr(terminal.input, TCSAFLUSH, &terminal.saved);
+    terminal.raw = 0;
+  }
+  if (terminal.owned)
+  {
+    close(terminal.input);
+    terminal.owned = 0;
+  }
+  terminal.input = -1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Switches the keyboard to unbuffered input without echo, so single keys
+/// can be polled for. Ctrl-C keeps interrupting. Without a terminal the
+/// run goes on without keys.
+///
+/// @return 1 if keys can be read, otherwise 0
+//
+int openTerminal(void)
+{
+  static int registered = 0;
+  struct termios settings;
+
+  terminal.input = STDIN_FILENO;
+  if (!isatty(terminal.input))
+  {
+    terminal.input = open(TERMINAL_PATH, O_RDONLY | O_NOCTTY);
+    terminal.owned = (terminal.input >= 0);
+  }
+  if (terminal.input < 0 || tcgetattr(terminal.input, &terminal.saved) != 0)
+  {
+    restoreTerminal();
+    return 0;
+  }
+  if (!registered)
+  {
+    atexit(restoreTerminal);
+    registered = 1;
+  }
+  settings = terminal.saved;
+  settings.c_lflag &= ~(ICANON | ECHO);
+  settings.c_cc[VMIN] = 1;
+  settings.c_cc[VTIME] = 0;
+  terminal.raw = (tcsetattr(terminal.input, TCSAFLUSH, &settings) == 0);
+  printf(KEYS_PROMPT);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Waits until a key is pressed, the deadline passes or a signal arrives.
+/// The arrow keys are returned as h, j, k and l.
+///
+/// @param deadline - the monotonic time to wait until, NULL to wait for a
+///                   key or signal only
+///
+/// @return the key, KEY_RESIZE if the terminal was resized, 0 otherwise
+//
+int waitForKey(const struct timespec *deadline)
+{
+  struct pollfd descriptor = { terminal.input, POLLIN, 0 };
+  int timeout = -1;
+  unsigned char key;
+  unsigned char sequence[2];
+  int ready;
+
+  if (deadline != NULL)
+  {
+    struct timespec now;
+    long long remaining;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    remaining = (deadline->tv_sec - now.tv_sec) * 1000LL + (deadline->tv_nsec - now.tv_nsec + 999999) / 1000000;
+    timeout = (remaining < 0) ? 0 : (remaining > INT32_MAX) ? INT32_MAX : (int) remaining;
+  }
+  // Without a keyboard poll only sleeps
+  ready = poll(&descriptor, terminal.input >= 0, timeout);
+  if (ready < 0 && errno == EINTR && terminal_resized)
+  {
+    return KEY_RESIZE;
+  }
+  if (ready <= 0 || !(descriptor.revents & POLLIN) || read(terminal.input, &key, 1) != 1)
+  {
+    return 0;
+  }
+  // Arrow keys arrive as escape sequences, which come in one piece
+  if (key == 27 && poll(&descriptor, 1, 0) == 1 && read(terminal.input, sequence, 2) == 2 && sequence[0] == '[' &&
+      sequence[1] >= 'A' && sequence[1] <= 'D')
+  {
+    return "kjlh"[sequence[1] - 'A'];
+  }
+  return key;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Moves a deadline a number of milliseconds ahead.
+///
+/// @param deadline - the deadline
+/// @param milliseconds - the milliseconds to add
+//
+void addMilliseconds(struct timespec *deadline, long milliseconds)
+{
+  deadline->tv_sec += milliseconds / 1000;
+  deadline->tv_nsec += (milliseconds % 1000) * 1000000L;
+  if (deadline->tv_nsec >= 1000000000L)
+  {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the current generation to a config file named after it.
+///
+/// @param board - the board
+//
+void saveSnapshot(Board *board)
+{
+  char path[64];
+
+  snprintf(path, sizeof(path), SNAPSHOT_PATH, board->generation);
+  if (writeConfigFile(board, path) == OK)
+  {
+    printf("-> Info: Saved generation %zu to \"%s\"\n", board->generation, path);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs every benchmark workload on the selected engines and writes the
+/// results as JSON. Only the generations are timed, not the board setup.
+///
+/// @param options - the parsed options
+///
+/// @return 0 if all results could be written, otherwise a value > 1
+//
+int runBenchmark(Options *options)
+{
+  FILE *output = fopen(options->bench_path, "w");
+  int first_result = 1;
+  size_t failures = 0;
+
+  if (output == NULL)
+  {
+    printf("-> Error: Could not open benchmark output \"%s\"!\n", options->bench_path);
+    return ERROR;
+  }
+  fprintf(output, "{\n  \"version\": \"%s\",\n  \"compiler\": \"%s\",\n  \"seed\": %llu,\n  \"results\": [",
+          GOL_VERSION, __VERSION__, (unsigned long long) BENCH_SEED);
+
+  for (size_t index = 0; index < WORKLOAD_COUNT && keep_running; index++)
+  {
+    const Workload *workload = &WORKLOADS[index];
+    if (options->bench_max_size != 0 &&
+        (workload->height > options->bench_max_size || workload->width > options->bench_max_size))
+    {
+      continue;
+    }
+
+    for (size_t engine = 0; engine < ENGINE_COUNT && keep_running; engine++)
+    {
+      Board *board = NULL;
+      PerfCounters counters;
+      size_t cells = workload->height * workload->width;
+
+      if (options->engine != NULL && options->engine != &ENGINES[engine])
+      {
+        continue;
+      }
+      printf("-> Bench: %s on %s (%zu generations)\n", workload->name, ENGINES[engine].name, workload->generations);
+      fflush(stdout);
+
+      fprintf(output, "%s\n    { \"workload\": \"%s\", \"engine\": \"%s\", \"height\": %zu, \"width\": %zu, "
+              "\"generations\": %zu, ", first_result ? "" : ",", workload->name, ENGINES[engine].name,
+              workload->height, workload->width, workload->generations);
+      first_result = 0;
+      resetPeakRss();
+      if (createWorkloadBoard(workload, &board))
+      {
+        fprintf(output, "\"error\": \"setup failed\" }");
+        freeBoard(board);
+        failures++;
+        continue;
+      }
+
+      if (options->perf_counters)
+      {
+        openPerfCounters(&counters, ENGINES[engine].name, worker_pool.size);
+      }
+      else
+      {
+        memset(&counters, 0, sizeof(counters));
+        for (size_t event = 0; event < PERF_EVENT_COUNT; event++)
+        {
+          counters.fd[0][event] = -1;
+        }
+      }
+      startPerfCounters(&counters);
+      advanceBoard(&ENGINES[engine], board, workload->generations);
+      stopPerfCounters(&counters, cells * workload->generations);
+      closePerfCounters(&counters);
+
+      // A run below the clock resolution has no rate, JSON has no infinity
+      fprintf(output, "\"seconds\": %.6f, ", counters.seconds);
+      if (counters.seconds > 0.0)
+      {
+        fprintf(output, "\"gens_per_second\": %.3f, \"cells_per_second\": %.1f, ",
+                workload->generations / counters.seconds, counters.cells / counters.seconds);
+      }
+      else
+      {
+        fprintf(output, "\"gens_per_second\": null, \"cells_per_second\": null, ");
+      }
+      fprintf(output, "\"peak_rss_kb\": %ld, \"huge_pages_kb\": %zu, \"final_population\": %zu", readPeakRss(),
+              countHugePageBytes(board) / 1024, countPopulation(board));
+      if (counters.fd[0][PERF_CYCLES] >= 0 && counters.fd[0][PERF_INSTRUCTIONS] >= 0 &&
+          counters.value[PERF_CYCLES] > 0 && counters.cells > 0)
+      {
+        fprintf(output, ", \"ipc\": %.3f, \"cycles_per_cell\": %.3f",
+                (double) counters.value[PERF_INSTRUCTIONS] / counters.value[PERF_CYCLES],
+                (double) counters.value[PERF_CYCLES] / counters.cells);
+      }
+      fprintf(output, " }");
+      fflush(output);
+      freeBoard(board);
+    }
+  }
+
+  fprintf(output, "\n  ]\n}\n");
+  if (fclose(output) != 0)
+  {
+    printf("-> Error: Could not write benchmark output \"%s\"!\n", options->bench_path);
+    return ERROR;
+  }
+  if (failures > 0)
+  {
+    printf("-> Error: %zu benchmark workloads could not be set up!\n", failures);
+    return ERROR;
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Copies the current generation, topology and generation count of a board
+/// into another of the same size. The activity tiles of the target are
+/// invalidated, its engine starts over from the copied cells.
+///
+/// @param target - the board to overwrite
+/// @param source - the board to copy
+//
+void copyBoardCells(Board *target, Board *source)
+{
+  for (size_t row = 0; row < source->height; row++)
+  {
+    memcpy(boardRow(target, target->current, row), boardRow(source, source->current, row), source->width);
+  }
+  target->topology = source->topology;
+  target->generation = source->generation;
+  target->activity_generation = SIZE_MAX;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reports the first cell in which an engine diverged from the reference,
+/// with everything needed to reproduce the trial.
+///
+/// @param check - the engine and soup of the trial
+/// @param expected - the reference board
+/// @param actual - the engine's board
+/// @param generation - the generation both boards are at
+/// @param pass - the generations the engine advanced in its last call
+//
+void reportDivergence(const CheckTrial *check, Board *expected, Board *actual, size_t generation, size_t pass)
+{
+  for (size_t row = 0; row < expected->height; row++)
+  {
+    uint8_t *expected_cells = boardRow(expected, expected->current, row);
+    uint8_t *actual_cells = boardRow(actual, actual->current, row);
+
+    for (size_t column = 0; column < expected->width; column++)
+    {
+      if (expected_cells[column] != actual_cells[column])
+      {
+        printf("-> Error: %s diverged in trial %zu (%zux%zu, %s, density %.2f, soup seed %" PRIu64 ") "
+               "at generation %zu", check->engine_name, check->trial, expected->height, expected->width,
+               (expected->topology == TOPOLOGY_TORUS) ? "torus" : "bounded", check->density, check->seed,
+               generation);
+        if (pass > 1)
+        {
+          printf(" (end of a %zu generation pass)", pass);
+        }
+        printf(", cell (%zu, %zu): expected '%c', got '%c'\n", row, column, expected_cells[column] ? '#' : '.',
+               actual_cells[column] ? '#' : '.');
+        return;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs the bit-sliced kernel of the ensembles and census against the
+/// reference updateBoard: every trial packs SLICED_LANES soups of one size
+/// into a batch and compares each lane with its own board after every
+/// generation. The first diverging cell of a failing trial is reported.
+///
+/// @param options - the parsed options
+/// @param random - the generator the trials are drawn from
+/// @param failures - receives the number of diverged trials added
+///
+/// @return 0 if the boards could be allocated, otherwise a value > 1
+//
+int checkSlicedBatch(Options *options, Random *random, size_t *failures)
+{
+  size_t sliced_failures = 0;
+
+  for (size_t trial = 0; trial < options->check_trials && keep_running; trial++)
+  {
+    Board *expected[SLICED_LANES] = { NULL };
+    double densities[SLICED_LANES];
+    uint64_t seeds[SLICED_LANES];
+    SlicedBatch *batch = NULL;
+    size_t board_height = 1 + nextRandom(random) % CHECK_MAX_HEIGHT;
+    size_t board_width = CHECK_WIDTHS[nextRandom(random) % CHECK_WIDTH_COUNT];
+    Topology topology = (nextRandom(random) & 1) ? TOPOLOGY_TORUS : TOPOLOGY_BOUNDED;
+    int diverged = 0;
+    int result = OK;
+
+    if (trial % 4 == 3)
+    {
+      (nextRandom(random) & 1) ? (board_height = 1) : (board_width = 1);
+    }
+    result = allocateSlicedBatch(&batch, board_height, board_width);
+    for (size_t lane = 0; lane < SLICED_LANES && result == OK; lane++)
+    {
+      densities[lane] = (nextRandom(random) % 100) / 100.0;
+      seeds[lane] = nextRandom(random);
+      result = allocateBoard(&expected[lane], board_height, board_width);
+      if (result == OK)
+      {
+        expected[lane]->topology = topology;
+        fillRandomBoard(expected[lane], densities[lane], seeds[lane]);
+        packSlicedBoard(batch, lane, expected[lane]);
+      }
+    }
+    if (result == OK)
+    {
+      batch->topology = topology;
+    }
+
+    for (size_t generation = 1; result == OK && generation <= CHECK_GENERATIONS && !diverged; generation++)
+    {
+      updateSlicedBatch(batch);
+      for (size_t lane = 0; lane < SLICED_LANES && !diverged; lane++)
+      {
+        updateBoard(expected[lane]);
+        for (size_t row = 0; row < board_height && !diverged; row++)
+        {
+          uint8_t *cells = boardRow(expected[lane], expected[lane]->current, row);
+          uint64_t *words = batch->current + (row + 1) * batch->stride + 1;
+
+          for (size_t column = 0; column < board_width; column++)
+          {
+            if (cells[column] != ((words[column] >> lane) & 1))
+            {
+              printf("-> Error: sliced diverged in trial %zu, lane %zu (%zux%zu, %s, density %.2f, soup seed %"
+                     PRIu64 ") at generation %zu, cell (%zu, %zu): expected '%c', got '%c'\n", trial, lane,
+                     board_height, board_width, (topology == TOPOLOGY_TORUS) ? "torus" : "bounded",
+                     densities[lane], seeds[lane], generation, row, column, cells[column] ? '#' : '.',
+                     cells[column] ? '.' : '#');
+              diverged = 1;
+              break;
+            }
+          }
+        }
+      }
+    }
+    sliced_failures += diverged;
+
+    for (size_t lane = 0; lane < SLICED_LANES; lane++)
+    {
+      freeBoard(expected[lane]);
+    }
+    freeSlicedBatch(batch);
+    if (result != OK)
+    {
+      return ERROR;
+    }
+  }
+
+  printf("-> Check: sliced %s (%zu of %zu trials diverged)\n", sliced_failures ? "FAILED" : "passed",
+         sliced_failures, options->check_trials);
+  *failures += sliced_failures;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs the reference updateBoard and the selected engines side by side on
+/// randomized boards and compares them after every generation, then once
+/// more in random multi-generation steps, followed by the sliced kernel
+/// when all engines are checked. The first
+/// diverging cell of a failing trial is reported together with everything
+/// needed to reproduce it.
+///
+/// @param options - the parsed options
+///
+/// @return 0 if all engines matched the reference, otherwise a value > 1
+//
+int runCheck(Options *options)
+{
+  Random random;
+  size_t failures = 0;
+
+  seedRandom(&random, options->seed);
+  for (size_t engine = 0; engine < ENGINE_COUNT && keep_running; engine++)
+  {
+    size_t engine_failures = 0;
+
+    if (options->engine != NULL && options->engine != &ENGINES[engine])
+    {
+      continue;
+    }
+
+    for (size_t trial = 0; trial < options->check_trials && keep_running; trial++)
+    {
+      Board *expected = NULL;
+      Board *actual = NULL;
+      Board *saved = NULL;
+      size_t board_height = 1 + nextRandom(&random) % CHECK_MAX_HEIGHT;
+      size_t board_width = CHECK_WIDTHS[nextRandom(&random) % CHECK_WIDTH_COUNT];
+      Topology topology = (nextRandom(&random) & 1) ? TOPOLOGY_TORUS : TOPOLOGY_BOUNDED;
+      double density = (nextRandom(&random) % 100) / 100.0;
+      uint64_t seed = nextRandom(&random);
+      CheckTrial check = { ENGINES[engine].name, trial, density, seed };
+      int diverged = 0;
+
+      // Every fourth trial uses a degenerate single row or column board
+      if (trial % 4 == 3)
+      {
+        (nextRandom(&random) & 1) ? (board_height = 1) : (board_width = 1);
+      }
+      if (allocateBoard(&expected, board_height, board_width) || allocateBoard(&actual, board_height, board_width) ||
+          allocateBoard(&saved, board_height, board_width))
+      {
+        freeBoard(expected);
+        freeBoard(actual);
+        freeBoard(saved);
+        return ERROR;
+      }
+      expected->topology = topology;
+      actual->topology = topology;
+      fillRandomBoard(expected, density, seed);
+      fillRandomBoard(actual, density, seed);
+
+      for (size_t generation = 1; generation <= CHECK_GENERATIONS && !diverged; generation++)
+      {
+        updateBoard(expected);
+        advanceBoard(&ENGINES[engine], actual, 1);
+        if (hashBoard(expected) != hashBoard(actual))
+        {
+          reportDivergence(&check, expected, actual, generation, 1);
+          diverged = 1;
+        }
+      }
+
+      // The same soup again in random steps so multi-generation passes are
+      // covered too. A diverging step is replayed from its start one
+      // generation at a time to find where the engine went wrong first.
+      fillRandomBoard(expected, density, seed);
+      fillRandomBoard(actual, density, seed);
+      for (size_t generation = 0; generation < CHECK_GENERATIONS && !diverged;)
+      {
+        size_t step = 1 + nextRandom(&random) % CHECK_MAX_STEP;
+
+        copyBoardCells(saved, actual);
+        for (size_t count = 0; count < step; count++)
+        {
+          updateBoard(expected);
+        }
+        advanceBoard(&ENGINES[engine], actual, step);
+        generation += step;
+        if (hashBoard(expected) == hashBoard(actual))
+        {
+          continue;
+        }
+
+        diverged = 1;
+        copyBoardCells(expected, saved);
+        for (size_t count = 1; count <= step; count++)
+        {
+          updateBoard(expected);
+          advanceBoard(&ENGINES[engine], saved, 1);
+          if (hashBoard(expected) != hashBoard(saved))
+          {
+            reportDivergence(&check, expected, saved, generation - step + count, 1);
+            break;
+          }
+          if (count == step)
+          {
+            // Stepped one by one the engine agrees, only the pass diverged
+            reportDivergence(&check, expected, actual, generation, step);
+          }
+        }
+      }
+      engine_failures += diverged;
+      freeBoard(expected);
+      freeBoard(actual);
+      freeBoard(saved);
+    }
+
+    printf("-> Check: %s %s (%zu of %zu trials diverged)\n", ENGINES[engine].name,
+           engine_failures ? "FAILED" : "passed", engine_failures, options->check_trials);
+    failures += engine_failures;
+  }
+
+  // The sliced kernel is no engine, it is checked along with all of them
+  if (options->engine == NULL && keep_running && checkSlicedBatch(options, &random, &failures))
+  {
+    return ERROR;
+  }
+  return failures ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Reads the list of config files of an ensemble, one path per line.
+///
+/// @param list_path - path to the list
+/// @param paths - receives the allocated list of paths
+/// @param path_count - receives the number of paths
+///
+/// @return 0 if the list could be read, otherwise a value > 1
+//
+int readEnsembleList(const char *list_path, char ***paths, size_t *path_count)
+{
+  FILE *list = fopen(list_path, "r");
+  char line[4096];
+  size_t capacity = 0;
+
+  *paths = NULL;
+  *path_count = 0;
+  if (list == NULL)
+  {
+    printf(ERROR_NO_FILE, list_path);
+    return ERROR;
+  }
+  while (fgets(line, sizeof(line), list) != NULL)
+  {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0')
+    {
+      continue;
+    }
+    if (*path_count == capacity)
+    {
+      char **grown = (char**) realloc(*paths, (capacity ? 2 * capacity : 64) * sizeof(char*));
+      if (grown == NULL)
+      {
+        fclose(list);
+        return ERROR;
+      }
+      *paths = grown;
+      capacity = capacity ? 2 * capacity : 64;
+    }
+    (*paths)[*path_count] = strdup(line);
+    if ((*paths)[*path_count] == NULL)
+    {
+      fclose(list);
+      return ERROR;
+    }
+    (*path_count)++;
+  }
+  fclose(list);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs one batch of SLICED_LANES consecutive soups of an ensemble through
+/// the bit-sliced kernel.
+///
+/// @param ensemble - the ensemble
+/// @param first - the index of the first soup of the batch
+/// @param scratch - a board of the soup size to generate the soups in
+/// @param batch - a batch of the soup size
+//
+void runSoupBatch(Ensemble *ensemble, size_t first, Board *scratch, SlicedBatch *batch)
+{
+  Options *options = ensemble->options;
+  size_t count = ensemble->board_count - first;
+  uint64_t lanes;
+  size_t board_generations = 0;
+
+  count = (count < SLICED_LANES) ? count : SLICED_LANES;
+  lanes = (count == SLICED_LANES) ? ~(uint64_t) 0 : ((uint64_t) 1 << count) - 1;
+  batch->topology = options->topology;
+  for (size_t lane = 0; lane < count; lane++)
+  {
+    fillRandomBoard(scratch, options->density, options->seed + first + lane);
+    packSlicedBoard(batch, lane, scratch);
+  }
+
+  runSlicedToStabilization(batch, lanes, options->max_generations, ensemble->results + first);
+  for (size_t lane = 0; lane < count; lane++)
+  {
+    ensemble->results[first + lane].height = batch->height;
+    ensemble->results[first + lane].width = batch->width;
+    board_generations += ensemble->results[first + lane].generations;
+  }
+  atomic_fetch_add(&ensemble->board_generations, board_generations);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job of an ensemble run. Boards are handed out through a shared
+/// counter, config files one at a time and soups in batches of SLICED_LANES.
+/// Config files are run to stabilization on the calling worker, soups all
+/// share one size and advance in lockstep in the bit-sliced kernel.
+///
+/// @param argument - the Ensemble
+/// @param worker - the worker index
+//
+void runEnsembleBoards(void *argument, size_t worker)
+{
+  Ensemble *ensemble = (Ensemble*) argument;
+  Options *options = ensemble->options;
+  Board *scratch = NULL;
+  SlicedBatch *batch = NULL;
+  size_t index;
+
+  (void) worker;
+  if (ensemble->paths == NULL)
+  {
+    if (allocateBoard(&scratch, options->soup_height, options->soup_width) ||
+        allocateSlicedBatch(&batch, options->soup_height, options->soup_width))
+    {
+      printf("-> Error: Out of memory in ensemble run!\n");
+      exit(ERROR);
+    }
+    while ((index = atomic_fetch_add(&ensemble->next_board, SLICED_LANES)) < ensemble->board_count &&
+           keep_running)
+    {
+      runSoupBatch(ensemble, index, scratch, batch);
+    }
+    freeSlicedBatch(batch);
+    freeBoard(scratch);
+    return;
+  }
+
+  while ((index = atomic_fetch_add(&ensemble->next_board, 1)) < ensemble->board_count && keep_running)
+  {
+    EnsembleResult *result = &ensemble->results[index];
+    Board *board = NULL;
+
+    result->failed = loadBoardFile(ensemble->paths[index], &board);
+    if (result->failed)
+    {
+      freeBoard(board);
+      continue;
+    }
+    result->height = board->height;
+    result->width = board->width;
+
+    board->topology = options->topology;
+    result->generations = runToStabilization(board, options->max_generations, &result->period);
+    result->population = countPopulation(board);
+    atomic_fetch_add(&ensemble->board_generations, result->generations);
+    freeBoard(board);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Simulates many independent boards concurrently and prints one summary
+/// line per board in input order. Every board runs until it stabilizes or
+/// hits the generation limit.
+///
+/// @param options - the parsed options
+///
+/// @return 0 if every board could be simulated, otherwise a value > 1
+//
+int runEnsemble(Options *options)
+{
+  Ensemble ensemble;
+  struct timespec start;
+  struct timespec stop;
+  size_t failures = 0;
+  double seconds;
+
+  memset(&ensemble, 0, sizeof(ensemble));
+  ensemble.options = options;
+  if (options->ensemble_path != NULL)
+  {
+    if (readEnsembleList(options->ensemble_path, &ensemble.paths, &ensemble.board_count))
+    {
+      return ERROR;
+    }
+  }
+  else
+  {
+    ensemble.board_count = options->soup_count;
+  }
+  ensemble.results = (EnsembleResult*) calloc(ensemble.board_count + SLICED_LANES, sizeof(EnsembleResult));
+  if (ensemble.results == NULL)
+  {
+    return ERROR;
+  }
+  atomic_init(&ensemble.next_board, 0);
+  atomic_init(&ensemble.board_generations, 0);
+
+  verbose = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  runWorkers(runEnsembleBoards, &ensemble);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  for (size_t index = 0; index < ensemble.board_count; index++)
+  {
+    EnsembleResult *result = &ensemble.results[index];
+
+    if (ensemble.paths != NULL)
+    {
+      printf("%s", ensemble.paths[index]);
+      free(ensemble.paths[index]);
+    }
+    else
+    {
+      printf("seed=%" PRIu64, options->seed + index);
+    }
+    if (result->failed)
+    {
+      printf(" failed\n");
+      failures++;
+      continue;
+    }
+    printf(" size=%zux%zu generations=%zu population=%zu period=%zu\n", result->width, result->height,
+           result->generations, result->population, result->period);
+  }
+  printf("-> Info: %zu boards, %zu board-generations in %.3f s (%.0f board-generations/s)\n",
+         ensemble.board_count, (size_t) atomic_load(&ensemble.board_generations), seconds,
+         atomic_load(&ensemble.board_generations) / seconds);
+
+  free(ensemble.paths);
+  free(ensemble.results);
+  return failures ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Adds occurrences of an apgcode to a census table.
+///
+/// @param table - the table
+/// @param code - the code, must outlive the table
+/// @param count - the number of occurrences
+//
+void countCensusCode(CensusTable *table, const char *code, size_t count)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  size_t slot;
+
+  for (const char *character = code; *character != '\0'; character++)
+  {
+    hash = (hash ^ (uint8_t) *character) * 0x100000001b3ULL;
+  }
+  if (table->count * 2 >= table->capacity)
+  {
+    size_t capacity = table->capacity ? 2 * table->capacity : CENSUS_TABLE_SIZE;
+    CensusCount *entries = (CensusCount*) calloc(capacity, sizeof(CensusCount));
+
+    if (entries == NULL)
+    {
+      printf("-> Error: Out of memory in census!\n");
+      exit(ERROR);
+    }
+    for (size_t old = 0; old < table->capacity; old++)
+    {
+      if (table->entries[old].code != NULL)
+      {
+        for (slot = table->entries[old].hash & (capacity - 1); entries[slot].code != NULL;
+             slot = (slot + 1) & (capacity - 1));
+        entries[slot] = table->entries[old];
+      }
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+  }
+
+  for (slot = hash & (table->capacity - 1); table->entries[slot].code != NULL; slot = (slot + 1) & (table->capacity - 1))
+  {
+    if (table->entries[slot].hash == hash && !strcmp(table->entries[slot].code, code))
+    {
+      table->entries[slot].count += count;
+      return;
+    }
+  }
+  table->entries[slot] = (CensusCount) { code, hash, count };
+  table->count++;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Separates the ash of a stabilized soup into objects and counts them.
+/// Objects that do not repeat on their own within the period of the soup
+/// are parts of a larger object, e.g. the quarters of a pulsar, and get
+/// merged with everything within two cells before they are counted.
+///
+/// @param worker - the census worker
+/// @param board - the soup
+/// @param period - the period of the soup
+//
+void censusBoard(CensusWorker *worker, Board *board, size_t period)
+{
+  ObjectList *list = &worker->objects;
+  int merge = 0;
+
+  if (findObjects(board, list))
+  {
+    printf("-> Error: Out of memory in census!\n");
+    exit(ERROR);
+  }
+  for (size_t object = 0; object < list->object_count; object++)
+  {
+    const Classification *classification = classifyObject(&worker->cache, list, &list->objects[object]);
+
+    list->merge[object] = (classification->kind == OBJECT_UNKNOWN || period % classification->period != 0);
+    merge |= list->merge[object];
+  }
+  if (merge)
+  {
+    joinNearbyRuns(list);
+    groupObjects(list);
+  }
+
+  for (size_t object = 0; object < list->object_count; object++)
+  {
+    countCensusCode(&worker->table, classifyObject(&worker->cache, list, &list->objects[object])->code, 1);
+  }
+  worker->object_count += list->object_count;
+  worker->stabilized++;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job of a census. Soups are handed out in batches of SLICED_LANES,
+/// run to stabilization in the bit-sliced kernel and their ash is counted in
+/// the table of the worker.
+///
+/// @param argument - the Census
+/// @param worker - the worker index
+//
+void runCensusSoups(void *argument, size_t worker)
+{
+  Census *census = (Census*) argument;
+  Options *options = census->options;
+  CensusWorker *tally = &census->workers[worker];
+  EnsembleResult results[SLICED_LANES];
+  Board *scratch = NULL;
+  SlicedBatch *batch = NULL;
+  size_t first;
+
+  if (allocateBoard(&scratch, options->soup_height, options->soup_width) ||
+      allocateSlicedBatch(&batch, options->soup_height, options->soup_width))
+  {
+    printf("-> Error: Out of memory in census!\n");
+    exit(ERROR);
+  }
+  while ((first = atomic_fetch_add(&census->next_soup, SLICED_LANES)) < options->census_soups && keep_running)
+  {
+    size_t count = options->census_soups - first;
+
+    count = (count < SLICED_LANES) ? count : SLICED_LANES;
+    for (size_t lane = 0; lane < count; lane++)
+    {
+      fillRandomBoard(scratch, options->density, options->seed + first + lane);
+      packSlicedBoard(batch, lane, scratch);
+    }
+    memset(results, 0, sizeof(results));
+    runSlicedToStabilization(batch, (count == SLICED_LANES) ? ~(uint64_t) 0 : ((uint64_t) 1 << count) - 1,
+                             options->max_generations, results);
+    for (size_t lane = 0; lane < count; lane++)
+    {
+      if (results[lane].period != 0)
+      {
+        unpackSlicedBoard(batch, lane, scratch);
+        censusBoard(tally, scratch, results[lane].period);
+      }
+    }
+  }
+  freeSlicedBatch(batch);
+  freeBoard(scratch);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Orders census counts by decreasing count, then by code.
+///
+/// @param first - a CensusCount
+/// @param second - another CensusCount
+///
+/// @return the qsort order
+//
+int compareCensusCounts(const void *first, const void *second)
+{
+  const CensusCount *left = (const CensusCount*) first;
+  const CensusCount *right = (const CensusCount*) second;
+
+  if (left->count != right->count)
+  {
+    return (left->count > right->count) ? -1 : 1;
+  }
+  return strcmp(left->code, right->code);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Runs a census of random soups: every soup is run to stabilization, its
+/// ash separated into objects and each object counted under its apgcode.
+/// Soups always run on bounded boards, objects never wrap around an edge.
+/// Objects only held in place by the dead cells beyond the edge do not
+/// repeat on their own and are counted as unknown.
+/// The merged table is printed sorted by count.
+///
+/// @param options - the parsed options
+///
+/// @return 0 if the census could be run, otherwise a value > 1
+//
+int runCensus(Options *options)
+{
+  Census census;
+  CensusTable total = { 0 };
+  CensusCount *sorted;
+  struct timespec start;
+  struct timespec stop;
+  size_t stabilized = 0;
+  size_t objects = 0;
+  size_t listed = 0;
+  double seconds;
+
+  census.options = options;
+  census.workers = (CensusWorker*) calloc(worker_pool.size, sizeof(CensusWorker));
+  if (census.workers == NULL)
+  {
+    return ERROR;
+  }
+  atomic_init(&census.next_soup, 0);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  runWorkers(runCensusSoups, &census);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  for (size_t worker = 0; worker < worker_pool.size; worker++)
+  {
+    CensusTable *table = &census.workers[worker].table;
+
+    for (size_t slot = 0; slot < table->capacity; slot++)
+    {
+      if (table->entries[slot].code != NULL)
+      {
+        countCensusCode(&total, table->entries[slot].code, table->entries[slot].count);
+      }
+    }
+    stabilized += census.workers[worker].stabilized;
+    objects += census.workers[worker].object_count;
+  }
+  sorted = (CensusCount*) malloc((total.count + 1) * sizeof(CensusCount));
+  if (sorted == NULL)
+  {
+    return ERROR;
+  }
+  for (size_t slot = 0; slot < total.capacity; slot++)
+  {
+    if (total.entries[slot].code != NULL)
+    {
+      sorted[listed++] = total.entries[slot];
+    }
+  }
+  qsort(sorted, listed, sizeof(CensusCount), compareCensusCounts);
+
+  printf("-> Census: %zu soups of %zux%zu, %zu stabilized, %zu objects in %.3f s (%.0f soups/s)\n",
+         options->census_soups, options->soup_width, options->soup_height, stabilized, objects, seconds,
+         options->census_soups / seconds);
+  printf("%12s  %s\n", "count", "object");
+  for (size_t entry = 0; entry < listed; entry++)
+  {
+    printf("%12zu  %s\n", sorted[entry].count, sorted[entry].code);
+  }
+
+  free(sorted);
+  free(total.entries);
+  for (size_t worker = 0; worker < worker_pool.size; worker++)
+  {
+    freeShapeCache(&census.workers[worker].cache);
+    free(census.workers[worker].table.entries);
+    freeObjectList(&census.workers[worker].objects);
+  }
+  free(census.workers);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Worker job classifying the share of objects owned by the worker, with a
+/// shape cache per worker.
+///
+/// @param argument - the Analysis
+/// @param worker - the worker index
+//
+void classifyObjectBand(void *argument, size_t worker)
+{
+  Analysis *analysis = (Analysis*) argument;
+  ObjectList *list = analysis->list;
+  size_t first;
+  size_t last;
+
+  bandRows(list->object_count, worker, &first, &last);
+  for (size_t object = first; object < last; object++)
+  {
+    analysis->classifications[object] = classifyObject(&analysis->caches[worker], list, &list->objects[object]);
+  }
+}
+
+//------------------------------------------------------------------------------
+///
+/// Writes the speed of a spaceship as a fraction of c, e.g. "c/4" or
+/// "2c/5", with its direction.
+///
+/// @param output - the output file
+/// @param classification - the classification of the spaceship
+//
+void writeVelocity(FILE *output, const Classification *classification)
+{
+  size_t rows = (size_t) llabs(classification->offset_y);
+  size_t columns = (size_t) llabs(classification->offset_x);
+  size_t distance = (rows > columns) ? rows : columns;
+  size_t period = classification->period;
+  size_t divisor;
+
+  // Reduce the fraction, both terms are at most CLASSIFY_MAX_PERIOD
+  for (divisor = distance; divisor > 1 && (distance % divisor || period % divisor); divisor--);
+  distance /= divisor;
+  period /= divisor;
+  if (distance == 1)
+  {
+    fprintf(output, ", \"velocity\": \"c/%zu\"", period);
+  }
+  else
+  {
+    fprintf(output, ", \"velocity\": \"%zuc/%zu\"", distance, period);
+  }
+  fprintf(output, ", \"direction\": \"%s\"",
+          (rows == 0 || columns == 0) ? "orthogonal" : (rows == columns) ? "diagonal" : "oblique");
+}
+
+//------------------------------------------------------------------------------
+///
+/// Finds the objects of the current generation, classifies each one by
+/// simulating it on its own and writes them as JSON, followed by a summary
+/// of the objects per apgcode. Objects do not wrap around the edges of torus
+/// boards.
+///
+/// @param options - the parsed options
+/// @param board - the board
+///
+/// @return 0 if the analysis could be written, otherwise a value > 1
+//
+int runAnalysis(Options *options, Board *board)
+{
+  ObjectList list = { 0 };
+  CensusTable table = { 0 };
+  Analysis analysis;
+  CensusCount *sorted = NULL;
+  struct timespec start;
+  struct timespec stop;
+  size_t listed = 0;
+  FILE *output;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  analysis.list = &list;
+  analysis.caches = (ShapeCache*) calloc(worker_pool.size, sizeof(ShapeCache));
+  if (analysis.caches == NULL || findObjects(board, &list))
+  {
+    free(analysis.caches);
+    freeObjectList(&list);
+    return ERROR;
+  }
+  analysis.classifications = (const Classification**) calloc(list.object_count + 1, sizeof(Classification*));
+  if (analysis.classifications == NULL)
+  {
+    free(analysis.caches);
+    freeObjectList(&list);
+    return ERROR;
+  }
+  runWorkers(classifyObjectBand, &analysis);
+  for (size_t object = 0; object < list.object_count; object++)
+  {
+    countCensusCode(&table, analysis.classifications[object]->code, 1);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  printf("-> Info: %zu objects found and classified in %.3f s\n", list.object_count,
+         (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9);
+
+  output = fopen(options->analyze_path, "w");
+  if (output == NULL)
+  {
+    printf("-> Error: Could not open analysis output \"%s\"!\n", options->analyze_path);
+  }
+  else
+  {
+    fprintf(output, "{\n  \"height\": %zu,\n  \"width\": %zu,\n  \"generation\": %zu,\n  \"object_count\": %zu,\n"
+            "  \"objects\": [", board->height, board->width, board->generation, list.object_count);
+    for (size_t object = 0; object < list.object_count; object++)
+    {
+      BoardObject *found = &list.objects[object];
+      const Classification *classification = analysis.classifications[object];
+
+      fprintf(output, "%s\n    { \"top\": %zu, \"left\": %zu, \"height\": %zu, \"width\": %zu, \"population\": %zu, "
+              "\"kind\": \"%s\", \"code\": \"%s\"", object ? "," : "", found->top, found->left, found->height,
+              found->width, found->population, OBJECT_KIND_NAMES[classification->kind], classification->code);
+      if (classification->kind != OBJECT_UNKNOWN)
+      {
+        fprintf(output, ", \"period\": %zu", classification->period);
+      }
+      if (classification->kind == OBJECT_SPACESHIP)
+      {
+        fprintf(output, ", \"offset_y\": %td, \"offset_x\": %td", classification->offset_y, classification->offset_x);
+        writeVelocity(output, classification);
+      }
+      fprintf(output, " }");
+    }
+
+    sorted = (CensusCount*) malloc((table.count + 1) * sizeof(CensusCount));
+    for (size_t slot = 0; sorted != NULL && slot < table.capacity; slot++)
+    {
+      if (table.entries[slot].code != NULL)
+      {
+        sorted[listed++] = table.entries[slot];
+      }
+    }
+    qsort(sorted, listed, sizeof(CensusCount), compareCensusCounts);
+    fprintf(output, "\n  ],\n  \"summary\": [");
+    for (size_t entry = 0; entry < listed; entry++)
+    {
+      fprintf(output, "%s\n    { \"code\": \"%s\", \"count\": %zu }", entry ? "," : "", sorted[entry].code,
+              sorted[entry].count);
+    }
+    fprintf(output, "\n  ]\n}\n");
+    fclose(output);
+  }
+
+  free(sorted);
+  free(table.entries);
+  free(analysis.classifications);
+  for (size_t worker = 0; worker < worker_pool.size; worker++)
+  {
+    freeShapeCache(&analysis.caches[worker]);
+  }
+  free(analysis.caches);
+  freeObjectList(&list);
+  return (output == NULL) ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Makes sure a recording buffer holds at least the given number of bytes.
+///
+/// @param buffer - the buffer, reallocated if needed
+/// @param capacity - the capacity of the buffer, updated if needed
+/// @param size - the required number of bytes
+///
+/// @return 0 if the buffer is large enough, otherwise a value > 1
+//
+int reserveRecordBuffer(uint8_t **buffer, size_t *capacity, size_t size)
+{
+  uint8_t *grown;
+
+  if (size <= *capacity)
+  {
+    return OK;
+  }
+  size = (size > 2 * *capacity) ? size : 2 * *capacity;
+  grown = (uint8_t*) realloc(*buffer, size);
+  if (grown == NULL)
+  {
+    return ERROR;
+  }
+  *buffer = grown;
+  *capacity = size;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Encodes the cells that differ between two packed boards as the gaps
+/// between their row-major indices, each a varint of 7 bits per byte.
+///
+/// @param packed - the packed rows of one generation
+/// @param previous - the packed rows of the other generation
+/// @param height - the number of rows
+/// @param width - the number of columns
+/// @param buffer - the buffer, grown as needed
+/// @param capacity - the capacity of the buffer
+/// @param size - receives the number of encoded bytes
+/// @param count - receives the number of flipped cells
+///
+/// @return 0 if the cells could be encoded, otherwise a value > 1
+//
+int encodeFlippedCells(const uint64_t *packed, const uint64_t *previous, size_t height, size_t width,
+                       uint8_t **buffer, size_t *capacity, size_t *size, uint64_t *count)
+{
+  size_t row_words = (width + 63) / 64;
+  uint64_t next_index = 0;
+
+  *size = 0;
+  *count = 0;
+  for (size_t row = 0; row < height; row++)
+  {
+    for (size_t word = 0; word < row_words; word++)
+    {
+      uint64_t flipped = packed[row * row_words + word] ^ previous[row * row_words + word];
+
+      while (flipped != 0)
+      {
+        uint64_t index = row * width + word * 64 + (uint64_t) __builtin_ctzll(flipped);
+        uint64_t gap = index - next_index;
+
+        if (reserveRecordBuffer(buffer, capacity, *size + 10))
+        {
+          return ERROR;
+        }
+        while (gap >= 0x80)
+        {
+          (*buffer)[(*size)++] = (uint8_t) (gap | 0x80);
+          gap >>= 7;
+        }
+        (*buffer)[(*size)++] = (uint8_t) gap;
+        next_index = index + 1;
+        (*count)++;
+        flipped &= flipped - 1;
+      }
+    }
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Flips the cells encoded by encodeFlippedCells on the board and, if given,
+/// in its packed copy. Costs time in proportion to the flipped cells.
+///
+/// @param board - the board
+/// @param packed - the packed copy of the board or NULL
+/// @param gaps - the encoded cells
+/// @param size - the number of encoded bytes
+///
+/// @return 0 if all cells lie on the board, otherwise a value > 1
+//
+int flipCells(Board *board, uint64_t *packed, const uint8_t *gaps, size_t size)
+{
+  uint64_t cell_count = (uint64_t) board->height * board->width;
+  size_t row_words = (board->width + 63) / 64;
+  uint64_t index = 0;
+
+  for (size_t position = 0; position < size;)
+  {
+    uint64_t gap = 0;
+    size_t row;
+    size_t column;
+
+    for (unsigned shift = 0; position < size && shift < 64; shift += 7)
+    {
+      gap |= (uint64_t) (gaps[position] & 0x7f) << shift;
+      if (gaps[position++] < 0x80)
+      {
+        break;
+      }
+    }
+    index += gap;
+    if (index >= cell_count)
+    {
+      return ERROR;
+    }
+    row = index / board->width;
+    column = index % board->width;
+    boardRow(board, board->current, row)[column] ^= 1;
+    if (packed != NULL)
+    {
+      packed[row * row_words + column / 64] ^= (uint64_t) 1 << (column % 64);
+    }
+    index++;
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Encodes, deflates and writes the frame of one generation. Keyframes hold
+/// the packed board, deltas the gaps between the indices of the cells that
+/// flipped since the previous generation as varints, so a delta costs bytes
+/// in proportion to the activity and nothing for a still board.
+///
+/// @param recorder - the recorder
+/// @param cells - the copy of the board rows
+/// @param generation - the generation of the copy
+///
+/// @return 0 if the frame could be written, otherwise a value > 1
+//
+int writeRecordFrame(Recorder *recorder, const uint8_t *cells, size_t generation)
+{
+  static const uint8_t padding[RECORD_ALIGNMENT] = { 0 };
+  RecordFrame frame = { generation, RECORD_DELTA, 0, 0, 0 };
+  size_t row_words = recorder->row_words;
+  size_t padding_size;
+  uint64_t *swap;
+  uLongf compressed_size;
+
+  for (size_t row = 0; row < recorder->height; row++)
+  {
+    packCellRow(cells + row * recorder->stride, recorder->width, recorder->packed + row * row_words);
+  }
+
+  if ((generation - recorder->header.first_generation) % recorder->header.keyframe_interval == 0)
+  {
+    frame.kind = RECORD_KEYFRAME;
+    frame.raw_size = recorder->height * row_words * sizeof(uint64_t);
+    if (reserveRecordBuffer(&recorder->raw, &recorder->raw_capacity, frame.raw_size))
+    {
+      return ERROR;
+    }
+    memcpy(recorder->raw, recorder->packed, frame.raw_size);
+    for (size_t word = 0; word < recorder->height * row_words; word++)
+    {
+      frame.cell_count += (uint64_t) __builtin_popcountll(recorder->packed[word]);
+    }
+    if (recorder->key_count == recorder->key_capacity)
+    {
+      size_t capacity = recorder->key_capacity ? 2 * recorder->key_capacity : 64;
+      RecordKey *grown = (RecordKey*) realloc(recorder->keys, capacity * sizeof(RecordKey));
+      if (grown == NULL)
+      {
+        return ERROR;
+      }
+      recorder->keys = grown;
+      recorder->key_capacity = capacity;
+    }
+    recorder->keys[recorder->key_count].generation = generation;
+    recorder->keys[recorder->key_count].offset = recorder->offset;
+    recorder->key_count++;
+  }
+  else
+  {
+    size_t raw_size;
+
+    if (encodeFlippedCells(recorder->packed, recorder->previous, recorder->height, recorder->width, &recorder->raw,
+                           &recorder->raw_capacity, &raw_size, &frame.cell_count))
+    {
+      return ERROR;
+    }
+    frame.raw_size = raw_size;
+  }
+
+  if (frame.raw_size != 0)
+  {
+    compressed_size = compressBound(frame.raw_size);
+    if (reserveRecordBuffer(&recorder->compressed, &recorder->compressed_capacity, compressed_size) ||
+        compress2(recorder->compressed, &compressed_size, recorder->raw, frame.raw_size, Z_BEST_SPEED) != Z_OK)
+    {
+      return ERROR;
+    }
+    frame.compressed_size = compressed_size;
+  }
+  padding_size = (RECORD_ALIGNMENT - frame.compressed_size % RECORD_ALIGNMENT) % RECORD_ALIGNMENT;
+  if (fwrite(&frame, sizeof(frame), 1, recorder->output) != 1 ||
+      fwrite(recorder->compressed, 1, frame.compressed_size, recorder->output) != frame.compressed_size ||
+      fwrite(padding, 1, padding_size, recorder->output) != padding_size)
+  {
+    return ERROR;
+  }
+  recorder->offset += sizeof(frame) + frame.compressed_size + padding_size;
+  recorder->header.generation_count++;
+
+  swap = recorder->previous;
+  recorder->previous = recorder->packed;
+  recorder->packed = swap;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Background thread of a recording, writing the handed over generations in
+/// order until the recording is stopped.
+///
+/// @param argument - the Recorder
+///
+/// @return NULL
+//
+void *runRecording(void *argument)
+{
+  Recorder *recorder = (Recorder*) argument;
+
+  pthread_mutex_lock(&recorder->lock);
+  while (1)
+  {
+    size_t slot;
+
+    while (recorder->tail == recorder->head && !recorder->closing)
+    {
+      pthread_cond_wait(&recorder->changed, &recorder->lock);
+    }
+    if (recorder->tail == recorder->head)
+    {
+      break;
+    }
+    slot = recorder->tail % RECORD_SLOTS;
+    pthread_mutex_unlock(&recorder->lock);
+
+    if (!recorder->failed && writeRecordFrame(recorder, recorder->slots[slot], recorder->generations[slot]))
+    {
+      recorder->failed = 1;
+    }
+
+    pthread_mutex_lock(&recorder->lock);
+    recorder->tail++;
+    pthread_cond_broadcast(&recorder->changed);
+  }
+  pthread_mutex_unlock(&recorder->lock);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Hands the current generation of the board to the recording thread. The
+/// simulation only pays for a copy of the rows, and waits only while all
+/// slots are still being written.
+///
+/// @param recorder - the recorder
+/// @param board - the board
+//
+void recordGeneration(Recorder *recorder, Board *board)
+{
+  size_t slot;
+
+  pthread_mutex_lock(&recorder->lock);
+  while (recorder->head - recorder->tail == RECORD_SLOTS)
+  {
+    pthread_cond_wait(&recorder->changed, &recorder->lock);
+  }
+  pthread_mutex_unlock(&recorder->lock);
+
+  slot = recorder->head % RECORD_SLOTS;
+  memcpy(recorder->slots[slot], boardRow(board, board->current, 0), board->height * board->stride);
+  recorder->generations[slot] = board->generation;
+
+  pthread_mutex_lock(&recorder->lock);
+  recorder->head++;
+  pthread_cond_broadcast(&recorder->changed);
+  pthread_mutex_unlock(&recorder->lock);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Releases the buffers of a recorder and closes its file.
+///
+/// @param recorder - the recorder
+//
+void freeRecorder(Recorder *recorder)
+{
+  if (recorder->output != NULL)
+  {
+    fclose(recorder->output);
+  }
+  free(recorder->slots[0]);
+  free(recorder->packed);
+  free(recorder->previous);
+  free(recorder->raw);
+  free(recorder->compressed);
+  free(recorder->keys);
+  free(recorder);
+}
+
+//------------------------------------------------------------------------------
+///
+/// Creates a recording of the board and records its current generation as
+/// the first keyframe.
+///
+/// @param board - the board
+/// @param file_path - path of the recording
+/// @param keyframe_interval - the number of generations between keyframes
+/// @param recorder - receives the recorder
+///
+/// @return 0 if the recording could be started, otherwise a value > 1
+//
+int startRecording(Board *board, const char *file_path, size_t keyframe_interval, Recorder **recorder)
+{
+  size_t slot_size = board->height * board->stride;
+  Recorder *created = (Recorder*) calloc(1, sizeof(Recorder));
+
+  *recorder = NULL;
+  if (created == NULL)
+  {
+    return ERROR;
+  }
+  created->path = file_path;
+  created->height = board->height;
+  created->width = board->width;
+  created->stride = board->stride;
+  created->row_words = (board->width + 63) / 64;
+  created->output = fopen(file_path, "wb");
+  created->slots[0] = (uint8_t*) malloc(RECORD_SLOTS * slot_size);
+  created->packed = (uint64_t*) calloc(board->height * created->row_words, sizeof(uint64_t));
+  created->previous = (uint64_t*) calloc(board->height * created->row_words, sizeof(uint64_t));
+  memcpy(created->header.magic, RECORD_MAGIC, sizeof(created->header.magic));
+  created->header.height = board->height;
+  created->header.width = board->width;
+  created->header.keyframe_interval = keyframe_interval;
+  created->header.first_generation = board->generation;
+  created->offset = sizeof(RecordHeader);
+  if (created->output == NULL || created->slots[0] == NULL || created->packed == NULL || created->previous == NULL ||
+      fwrite(&created->header, sizeof(RecordHeader), 1, created->output) != 1)
+  {
+    printf("-> Error: Could not write recording \"%s\"!\n", file_path);
+    freeRecorder(created);
+    return ERROR;
+  }
+  for (size_t slot = 1; slot < RECORD_SLOTS; slot++)
+  {
+    created->slots[slot] = created->slots[0] + slot * slot_size;
+  }
+
+  pthread_mutex_init(&created->lock, NULL);
+  pthread_cond_init(&created->changed, NULL);
+  if (pthread_create(&created->thread, NULL, runRecording, created))
+  {
+    pthread_mutex_destroy(&created->lock);
+    pthread_cond_destroy(&created->changed);
+    freeRecorder(created);
+    return ERROR;
+  }
+  *recorder = created;
+  recordGeneration(created, board);
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Waits for the recording thread to write all handed over generations,
+/// appends the keyframe index and completes the header.
+///
+/// @param recorder - the recorder, may be NULL
+///
+/// @return 0 if the recording is complete, otherwise a value > 1
+//
+int stopRecording(Recorder *recorder)
+{
+  int failed;
+
+  if (recorder == NULL)
+  {
+    return OK;
+  }
+  pthread_mutex_lock(&recorder->lock);
+  recorder->closing = 1;
+  pthread_cond_broadcast(&recorder->changed);
+  pthread_mutex_unlock(&recorder->lock);
+  pthread_join(recorder->thread, NULL);
+  pthread_mutex_destroy(&recorder->lock);
+  pthread_cond_destroy(&recorder->changed);
+
+  recorder->header.keyframe_count = recorder->key_count;
+  recorder->header.index_offset = recorder->offset;
+  failed = recorder->failed ||
+           fwrite(recorder->keys, sizeof(RecordKey), recorder->key_count, recorder->output) != recorder->key_count ||
+           fseek(recorder->output, 0, SEEK_SET) != 0 ||
+           fwrite(&recorder->header, sizeof(RecordHeader), 1, recorder->output) != 1;
+  failed |= (fclose(recorder->output) != 0);
+  recorder->output = NULL;
+  if (failed)
+  {
+    printf("-> Error: Could not write recording \"%s\"!\n", recorder->path);
+  }
+  else if (verbose)
+  {
+    printf("-> Info: Recorded %" PRIu64 " generations with %zu keyframes, %.1f KiB\n",
+           recorder->header.generation_count, recorder->key_count,
+           (recorder->offset + recorder->key_count * sizeof(RecordKey)) / 1024.0);
+  }
+  freeRecorder(recorder);
+  return failed ? ERROR : OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Maps a recording into memory and checks its header and keyframe index.
+///
+/// @param file_path - path of the recording
+/// @param replay - receives the mapped recording
+///
+/// @return 0 if the recording can be replayed, otherwise a value > 1
+//
+int openReplay(const char *file_path, Replay *replay)
+{
+  int descriptor = open(file_path, O_RDONLY);
+  struct stat status;
+  const RecordHeader *header;
+
+  memset(replay, 0, sizeof(Replay));
+  if (descriptor < 0)
+  {
+    printf(ERROR_NO_FILE, file_path);
+    return ERROR;
+  }
+  if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(RecordHeader))
+  {
+    close(descriptor);
+    printf("-> Error: \"%s\" is no complete recording!\n", file_path);
+    return ERROR;
+  }
+  replay->size = (size_t) status.st_size;
+  replay->data = (const uint8_t*) mmap(NULL, replay->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  close(descriptor);
+  if (replay->data == MAP_FAILED)
+  {
+    replay->data = NULL;
+    printf("-> Error: Could not map recording \"%s\"!\n", file_path);
+    return ERROR;
+  }
+
+  header = (const RecordHeader*) replay->data;
+  if (memcmp(header->magic, RECORD_MAGIC, sizeof(header->magic)) || header->height == 0 || header->width == 0 ||
+      header->keyframe_interval == 0 || header->keyframe_count == 0 || header->index_offset < sizeof(RecordHeader) ||
+      header->index_offset % RECORD_ALIGNMENT != 0 ||
+      header->index_offset > replay->size ||
+      header->keyframe_count > (replay->size - header->index_offset) / sizeof(RecordKey))
+  {
+    printf("-> Error: \"%s\" is no complete recording!\n", file_path);
+    munmap((void*) replay->data, replay->size);
+    replay->data = NULL;
+    return ERROR;
+  }
+  replay->header = header;
+  replay->keys = (const RecordKey*) (replay->data + header->index_offset);
+  replay->span = (uint64_t*) malloc(header->keyframe_interval * sizeof(uint64_t));
+  replay->span_key = SIZE_MAX;
+  if (replay->span == NULL)
+  {
+    munmap((void*) replay->data, replay->size);
+    replay->data = NULL;
+    return ERROR;
+  }
+  if (verbose)
+  {
+    printf("-> Info: Recording of %" PRIu64 " generations from %" PRIu64 ", Rows = %" PRIu64 ", Columns = %" PRIu64
+           "\n", header->generation_count, header->first_generation, header->height, header->width);
+  }
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Unmaps a recording.
+///
+/// @param replay - the mapped recording
+//
+void closeReplay(Replay *replay)
+{
+  if (replay->data != NULL)
+  {
+    munmap((void*) replay->data, replay->size);
+  }
+  free(replay->raw);
+  free(replay->span);
+  memset(replay, 0, sizeof(Replay));
+}
+
+//------------------------------------------------------------------------------
+///
+/// Applies a frame of a recording to the board: a keyframe replaces the
+/// cells, a delta flips the listed ones. Flipping is its own inverse, so the
+/// delta of a generation also leads back to the one before.
+///
+/// @param replay - the mapped recording
+/// @param board - the board
+/// @param offset - the offset of the frame
+/// @param generation - the expected generation of the frame
+///
+/// @return 0 if the frame could be applied, otherwise a value > 1
+//
+int applyReplayFrame(Replay *replay, Board *board, uint64_t offset, uint64_t generation)
 {
-  char current_value;
-  char new_value;
-} Cell;
+  const RecordHeader *header = replay->header;
+  RecordFrame frame;
+  uLongf raw_size;
+
+  if (offset > header->index_offset || header->index_offset - offset < sizeof(RecordFrame))
+  {
+    return ERROR;
+  }
+  memcpy(&frame, replay->data + offset, sizeof(frame));
+  if (frame.generation != generation || frame.kind > RECORD_DELTA ||
+      frame.compressed_size > header->index_offset - offset - sizeof(frame) ||
+      (frame.kind == RECORD_KEYFRAME && frame.raw_size != header->height * ((header->width + 63) / 64) * 8))
+  {
+    return ERROR;
+  }
+  raw_size = frame.raw_size;
+  if (reserveRecordBuffer(&replay->raw, &replay->raw_capacity, frame.raw_size + 1) ||
+      (frame.raw_size != 0 && (uncompress(replay->raw, &raw_size, replay->data + offset + sizeof(frame),
+                                          frame.compressed_size) != Z_OK || raw_size != frame.raw_size)))
+  {
+    return ERROR;
+  }
+
+  if (frame.kind == RECORD_KEYFRAME)
+  {
+    size_t row_words = (header->width + 63) / 64;
+
+    for (size_t row = 0; row < board->height; row++)
+    {
+      uint8_t *cells = boardRow(board, board->current, row);
+      const uint8_t *bytes = replay->raw + row * row_words * sizeof(uint64_t);
 
+      for (size_t column = 0; column < board->width; column++)
+      {
+        cells[column] = (bytes[column / 8] >> (column % 8)) & 1;
+      }
+    }
+    return OK;
+  }
+  return flipCells(board, NULL, replay->raw, frame.raw_size);
+}
 
 //------------------------------------------------------------------------------
 ///
-/// Checks if the command line parameters are correct.
+/// Brings the board to a generation of the recording, clamped to the
+/// recorded ones. Within the span of the current keyframe the board steps
+/// forward and backward frame by frame, elsewhere the nearest keyframe at
+/// or before the generation is found by binary search and the deltas up to
+/// the generation are applied, so a seek costs at most one keyframe interval
+/// of frames wherever it goes.
 ///
-/// @param argc - the argument count
-/// @param argv - a list of command strings
-/// @param file_path - path to the config file
+/// @param replay - the mapped recording
+/// @param board - the board of the recording's size
+/// @param generation - the generation to show
 ///
-/// @return 0 if parameters are valid, otherwise a value > 1
+/// @return 0 if the generation could be restored, otherwise a value > 1
 //
-int checkParams(int argc, char *argv[], char **file_path)
+int seekReplay(Replay *replay, Board *board, uint64_t generation)
 {
-  if (argc == 1)
+  const RecordHeader *header = replay->header;
+  uint64_t last = header->first_generation + header->generation_count - 1;
+  size_t low = 0;
+  size_t high = header->keyframe_count;
+  uint64_t key_generation;
+
+  generation = (generation < header->first_generation) ? header->first_generation :
+               (generation > last) ? last : generation;
+  while (high - low > 1)
   {
-    printf(INFO_DEFAULT_FILE, DEFAULT_CONFIG_PATH);
-    *file_path = (char*) calloc(sizeof(char), sizeof(DEFAULT_CONFIG_PATH));
-    if (*file_path == NULL)
+    size_t middle = low + (high - low) / 2;
+    if (replay->keys[middle].generation <= generation)
+    {
+      low = middle;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  key_generation = replay->keys[low].generation;
+  if (generation < key_generation || generation - key_generation >= header->keyframe_interval)
+  {
+    return ERROR;
+  }
+
+  if (replay->span_key != low)
+  {
+    replay->span_key = SIZE_MAX;
+    if (applyReplayFrame(replay, board, replay->keys[low].offset, key_generation))
     {
       return ERROR;
     }
-    strcpy(*file_path, DEFAULT_CONFIG_PATH);
+    replay->span[0] = replay->keys[low].offset;
+    replay->span_key = low;
+    replay->generation = key_generation;
   }
-  else if (argc == 3)
+  while (replay->generation > generation)
   {
-    if (!strcmp(argv[1], "-f"))
-    { 
-      printf("-> Using configuration file: %s\n", argv[2]);
-      *file_path = (char*) calloc(sizeof(char), strlen(argv[2]) + 1);
-      if (*file_path == NULL)
-      {
-        return ERROR;
-      }
-      strcpy(*file_path, argv[2]);
+    if (applyReplayFrame(replay, board, replay->span[replay->generation - key_generation], replay->generation))
+    {
+      replay->span_key = SIZE_MAX;
+      return ERROR;
     }
-    else
+    replay->generation--;
+  }
+  while (replay->generation < generation)
+  {
+    uint64_t *span = replay->span + (replay->generation - key_generation);
+    RecordFrame frame;
+
+    memcpy(&frame, replay->data + span[0], sizeof(frame));
+    span[1] = span[0] + sizeof(frame) + (frame.compressed_size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    if (applyReplayFrame(replay, board, span[1], replay->generation + 1))
     {
-      printf(USAGE_PROMPT);
+      replay->span_key = SIZE_MAX;
       return ERROR;
     }
+    replay->generation++;
   }
-  else
+  board->generation = replay->generation;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Starts the history of an interactive run at the current generation.
+///
+/// @param board - the board
+/// @param budget - the number of bytes the deltas may take
+/// @param history - receives the empty history
+///
+/// @return 0 if the history could be started, otherwise a value > 1
+//
+int startHistory(Board *board, size_t budget, History *history)
+{
+  memset(history, 0, sizeof(History));
+  history->height = board->height;
+  history->width = board->width;
+  history->row_words = (board->width + 63) / 64;
+  history->budget = budget;
+  history->packed = (uint64_t*) calloc(board->height * history->row_words, sizeof(uint64_t));
+  history->previous = (uint64_t*) calloc(board->height * history->row_words, sizeof(uint64_t));
+  if (history->packed == NULL || history->previous == NULL)
   {
-    printf(USAGE_PROMPT);
+    free(history->packed);
+    free(history->previous);
     return ERROR;
   }
+  for (size_t row = 0; row < board->height; row++)
+  {
+    packCellRow(boardRow(board, board->current, row), board->width, history->previous + row * history->row_words);
+  }
   return OK;
 }
 
 //------------------------------------------------------------------------------
 ///
-/// Checks if the config file is valid.
+/// Releases a history.
 ///
-/// @param config_file - the actual loaded config file
-/// @param file_path - path to the config file
-/// @param board_height - pointer to the height of the board
-/// @param board_width - pointer to the width of the board
+/// @param history - the history
+//
+void freeHistory(History *history)
+{
+  for (size_t delta = 0; delta < history->count; delta++)
+  {
+    free(history->deltas[(history->first + delta) % history->capacity].gaps);
+  }
+  free(history->deltas);
+  free(history->packed);
+  free(history->previous);
+  free(history->scratch);
+  memset(history, 0, sizeof(History));
+}
+
+//------------------------------------------------------------------------------
 ///
-/// @return 0 if file is valid, otherwise a value > 1
+/// Remembers the cells flipped by the step to the current generation. The
+/// oldest deltas are dropped while the deltas exceed the budget.
+///
+/// @param history - the history
+/// @param board - the board, one generation after the last push
+///
+/// @return 0 if the delta could be kept, otherwise a value > 1
 //
-int checkConfigFile(FILE **config_file, char *file_path, uint8_t *board_height, uint8_t *board_width)
+int pushHistory(History *history, Board *board)
 {
-  *config_file = fopen(file_path, "rb");
+  HistoryDelta delta;
+  uint64_t cell_count;
+  uint64_t *swap;
 
-  if (*config_file == NULL)
+  for (size_t row = 0; row < history->height; row++)
+  {
+    packCellRow(boardRow(board, board->current, row), history->width, history->packed + row * history->row_words);
+  }
+  if (encodeFlippedCells(history->packed, history->previous, history->height, history->width, &history->scratch,
+                         &history->scratch_capacity, &delta.size, &cell_count))
   {
-    printf(ERROR_NO_FILE, file_path);
     return ERROR;
   }
+  swap = history->previous;
+  history->previous = history->packed;
+  history->packed = swap;
 
-  int last_column_count = 0;
-  int current_column_count = 0;
-  int row_count = 0;
-  while (!feof(*config_file))
+  delta.gaps = (uint8_t*) malloc(delta.size + 1);
+  if (delta.gaps == NULL)
   {
-    char current_char = fgetc(*config_file);
-    current_column_count++;
-    if (current_char == '\n')
-    {
-      (last_column_count == 0) ? (last_column_count = current_column_count) : (last_column_count);
-      if (last_column_count != current_column_count)
-      {
-        printf("-> Error: Inconsistent column count detected!\n");
-        fclose(*config_file);
-        return ERROR;
-      }
-      row_count++;
-      current_column_count = 0;
-    }
-    else if (current_char == EOF)
+    return ERROR;
+  }
+  memcpy(delta.gaps, history->scratch, delta.size);
+  if (history->count == history->capacity)
+  {
+    size_t capacity = history->capacity ? 2 * history->capacity : 64;
+    HistoryDelta *grown = (HistoryDelta*) malloc(capacity * sizeof(HistoryDelta));
+    if (grown == NULL)
     {
-      if (last_column_count != current_column_count)
-      {
-        printf("-> Error: Inconsistent column count detected!\n");
-        fclose(*config_file);
-        return ERROR;
-      }
-      break;
+      free(delta.gaps);
+      return ERROR;
     }
-    else if (current_char != '.' && current_char != '#')
+    for (size_t entry = 0; entry < history->count; entry++)
     {
-      printf("-> Error: Invalid char \"%c\" detected!\n", current_char);
-      fclose(*config_file);
-      return ERROR;
+      grown[entry] = history->deltas[(history->first + entry) % history->capacity];
     }
-    
+    free(history->deltas);
+    history->deltas = grown;
+    history->capacity = capacity;
+    history->first = 0;
   }
+  history->deltas[(history->first + history->count) % history->capacity] = delta;
+  history->count++;
+  history->bytes += delta.size + sizeof(HistoryDelta);
 
-  *board_width = last_column_count - 1;
-  *board_height = row_count + 1;
-
-  printf("-> Info: Rows = %d, Columns = %d\n", *board_height, *board_width);
+  while (history->count > 0 && history->bytes > history->budget)
+  {
+    HistoryDelta *oldest = &history->deltas[history->first];
+    history->bytes -= oldest->size + sizeof(HistoryDelta);
+    free(oldest->gaps);
+    history->first = (history->first + 1) % history->capacity;
+    history->count--;
+  }
   return OK;
 }
 
 //------------------------------------------------------------------------------
 ///
-/// Fills the board and checks if board is valid.
+/// Steps the board back one generation by flipping the cells of the newest
+/// delta again, in time proportional to the flipped cells.
 ///
-/// @param config_file - the actual loaded config file
-/// @param board - a 2D representation of the board
-/// @param board_height - the height of the board
-/// @param board_width - the width of the board
+/// @param history - the history
+/// @param board - the board
 ///
-/// @return 0 if board is valid, otherwise a value > 1
+/// @return 0 if the board stepped back, otherwise a value > 1 when the
+///         history is exhausted or the newest delta does not fit the board,
+///         in which case the delta stays in the history
 //
-int fillBoard(FILE *config_file, Cell ***board, uint8_t board_height, uint8_t board_width)
+int stepHistoryBack(History *history, Board *board)
 {
-  rewind(config_file);
-  *board = (Cell**) calloc(board_height, sizeof(Cell*));
-  if (*board == NULL)
+  HistoryDelta *newest;
+  int result;
+
+  if (history->count == 0)
   {
     return ERROR;
   }
-  for (uint8_t row = 0; row < board_height; row++)
+  newest = &history->deltas[(history->first + history->count - 1) % history->capacity];
+  result = flipCells(board, history->previous, newest->gaps, newest->size);
+
+  // The activity tiles describe the generation stepped away from
+  board->activity_generation = SIZE_MAX;
+  if (result)
   {
-    (*board)[row] = (Cell*) calloc(board_width, sizeof(Cell));
-    if ((*board)[row] == NULL)
-    {
-      return ERROR;
-    }
+    return result;
   }
+  history->bytes -= newest->size + sizeof(HistoryDelta);
+  free(newest->gaps);
+  history->count--;
+  board->generation--;
+  return OK;
+}
+
+//------------------------------------------------------------------------------
+///
+/// Advances the board to the requested generation as fast as the engine
+/// allows, without rendering. The engine advances in chunks sized to take
+/// about PROGRESS_INTERVAL seconds each, between which the progress is
+/// reported on stderr. An interrupt stops at the end of the current chunk.
+/// While recording, the engine advances one generation at a time.
+///
+/// @param engine - the engine
+/// @param board - the board
+/// @param generations - the number of generations to advance
+/// @param recorder - the recorder or NULL
+///
+/// @return 0 if all generations were advanced, otherwise a value > 1 when
+///         an interrupt stopped the jump early
+//
+int jumpBoard(const Engine *engine, Board *board, size_t generations, Recorder *recorder)
+{
+  struct timespec start;
+  struct timespec now;
+  size_t chunk = 1;
+  size_t done = 0;
+  double seconds = 0.0;
 
-  for (uint8_t row = 0; row < board_height; row++)
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (done < generations && keep_running)
   {
-    char current_char;
-    for (uint8_t column = 0; column < board_width; column++)
+    double elapsed;
+    size_t step = (chunk < generations - done) ? chunk : generations - done;
+
+    if (recorder == NULL)
+    {
+      advanceBoard(engine, board, step);
+    }
+    for (size_t generation = 0; recorder != NULL && generation < step; generation++)
+    {
+      advanceBoard(engine, board, 1);
+      recordGeneration(recorder, board);
+    }
+    done += step;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed = (now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
+    if (elapsed - seconds < PROGRESS_INTERVAL / 2 && chunk < SIZE_MAX / 2)
+    {
+      chunk *= 2;
+    }
+    else if (elapsed - seconds > PROGRESS_INTERVAL * 2 && chunk > 1)
     {
-      current_char = fgetc(config_file);
-      (*board)[row][column].current_value = current_char;
-      (*board)[row][column].new_value = current_char;
+      chunk /= 2;
     }
-    current_char = fgetc(config_file);
+    seconds = elapsed;
+    fprintf(stderr, "\r-> Progress: %zu / %zu generations (%.1f%%), %.0f gens/s   ", done, generations,
+            100.0 * done / generations, done / seconds);
   }
-
-  return OK;
+  if (generations != 0)
+  {
+    fprintf(stderr, "\n");
+  }
+  return (done < generations) ? ERROR : OK;
 }
 
 //------------------------------------------------------------------------------
 ///
-/// Updates all the cells of the board for the next step
+/// Replays a recording from the --seek generation, rendering a generation
+/// per second and moving --replay-step generations, backwards if negative.
+/// The replay pauses at either end of the recording, without a keyboard it
+/// ends there. With --output the sought generation is written instead.
 ///
-/// @param board - a 2D representation of the board
-/// @param board_height - the height of the board
-/// @param board_width - the width of the board
+/// @param options - the parsed options
+///
+/// @return 0 if the recording could be replayed, otherwise a value > 1
 //
-void updateBoard(Cell **board, int board_height, int board_width)
+int runReplay(Options *options)
 {
-  Neighbour neighbour[8] = { {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1} };
+  Replay replay;
+  Board *board = NULL;
+  struct timespec start;
+  struct timespec stop;
+  uint64_t first;
+  uint64_t last;
+  int result;
 
-  for (size_t row = 0; row < board_height; row++)
+  if (openReplay(options->replay_path, &replay))
   {
-    for (size_t column = 0; column < board_width; column++)
+    return ERROR;
+  }
+  first = replay.header->first_generation;
+  last = first + replay.header->generation_count - 1;
+  if (allocateBoard(&board, replay.header->height, replay.header->width))
+  {
+    closeReplay(&replay);
+    return ERROR;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  result = seekReplay(&replay, board, options->seek_generation);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  if (result == OK && verbose)
+  {
+    printf("-> Info: Sought generation %zu in %.3f ms\n", board->generation,
+           (stop.tv_sec - start.tv_sec) * 1e3 + (stop.tv_nsec - start.tv_nsec) / 1e6);
+  }
+  if (result == OK && options->output_path != NULL)
+  {
+    result = hasExtension(options->output_path, ".mc") ? writeMacrocellFile(board, options->output_path) :
+             hasExtension(options->output_path, ".lif") ? writeLife106File(board, options->output_path) :
+             writeConfigFile(board, options->output_path);
+  }
+  else if (result == OK)
+  {
+    int keys = openTerminal();
+    int paused = 0;
+    int render = 1;
+    long delay = INTERACTIVE_DELAY_MS;
+    struct timespec deadline;
+    Viewport viewport = { .zoom = 1, .mode = options->render_mode };
+
+    printf("\n============ GOL - Game Of Life ============\n");
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    addMilliseconds(&deadline, delay);
+    while (keep_running && result == OK)
     {
-      size_t neighbour_count = 0;
-      
-      // Checking all 8 neighbours
-      for (size_t count = 0; count < 8; count++)
-      {
-        if (row + neighbour[count].offset_y >= board_height || column + neighbour[count].offset_x >= board_width)
-        {
-          continue;
-        }
-        if (board[row + neighbour[count].offset_y][column + neighbour[count].offset_x].current_value == '#')
-        {
-          neighbour_count++;
-        }
-      }
-      // We are on a live cell and we have two or three live neighbours = survive
-      if (board[row][column].current_value == '#' && (neighbour_count == 2 || neighbour_count == 3))
+      uint64_t generation = board->generation;
+      int at_end = (options->replay_step > 0 && generation == last) ||
+                   (options->replay_step < 0 && generation == first);
+
+      if (render)
       {
-        board[row][column].new_value = '#';
+        updateViewport(&viewport, board);
+        printf("Generation: %zu\n╔", board->generation);
+        printViewport(board, &viewport);
+        render = 0;
       }
-      // We are on a dead cell and we have exactly three neighbours = become alive
-      else if (board[row][column].current_value == '.' && neighbour_count == 3)
+      if (at_end && !paused)
       {
-        board[row][column].new_value = '#';
+        if (!keys)
+        {
+          break;
+        }
+        printf("-> Info: End of the recording, paused\n");
+        paused = 1;
       }
-      // Otherwise the cell dies/stays dead
-      else
+
+      int key = waitForKey(paused ? NULL : &deadline);
+      switch (key)
       {
-        board[row][column].new_value = '.';
+        case 0:
+          if (paused || !keep_running)
+          {
+            continue;
+          }
+          generation = (options->replay_step < 0 && generation - first < (uint64_t) -options->replay_step) ? first :
+                       generation + (uint64_t) options->replay_step;
+          addMilliseconds(&deadline, delay);
+          break;
+        case ' ':
+          paused = !paused;
+          printf("-> Info: %s\n", paused ? "Paused" : "Resumed");
+          clock_gettime(CLOCK_MONOTONIC, &deadline);
+          addMilliseconds(&deadline, delay);
+          continue;
+        case 'n':
+          generation += (generation < last);
+          break;
+        case 'b':
+          generation -= (generation > first);
+          break;
+        case '+':
+          delay = (delay / 2 < INTERACTIVE_MIN_DELAY_MS) ? INTERACTIVE_MIN_DELAY_MS : delay / 2;
+          printf("-> Info: %ld ms per generation\n", delay);
+          continue;
+        case '-':
+          delay = (delay * 2 > INTERACTIVE_MAX_DELAY_MS) ? INTERACTIVE_MAX_DELAY_MS : delay * 2;
+          printf("-> Info: %ld ms per generation\n", delay);
+          continue;
+        case 's':
+          saveSnapshot(board);
+          continue;
+        case 'q':
+          keep_running = 0;
+          continue;
+        case KEY_RESIZE:
+          render = 1;
+          continue;
+        default:
+          render = moveViewport(&viewport, board, key);
+          continue;
       }
+      render = (generation != board->generation);
+      result = seekReplay(&replay, board, generation);
     }
+    restoreTerminal();
   }
-
-  // Persist values
-  for (size_t row = 0; row < board_height; row++)
+  if (result != OK)
   {
-    for (size_t column = 0; column < board_width; column++)
-    {
-      board[row][column].current_value = board[row][column].new_value;
-    }
+    printf("-> Error: Recording \"%s\" is corrupt!\n", options->replay_path);
   }
+  freeBoard(board);
+  closeReplay(&replay);
+  return result;
 }
 
 //------------------------------------------------------------------------------
 ///
-/// Prints the whole board to the console
+/// Creates the board of an interactive run, either as a random soup or from
+/// the config file, which defaults to the standard one.
 ///
-/// @param board - a 2D representation of the board
-/// @param board_height - the height of the board
-/// @param board_width - the width of the board
+/// @param options - the parsed options
+/// @param board - receives the board
+///
+/// @return 0 if the board could be created, otherwise a value > 1
 //
-void printBoard(Cell **board, int board_height, int board_width)
+int loadBoard(Options *options, Board **board)
 {
-  for (uint8_t column = 0; column < board_width; column++)
-  {
-    printf("═");
-  }
-  printf("╗\n");
-  for (uint8_t row = 0; row < board_height; row++)
+  if (options->random_width != 0)
   {
-    printf("║");
-    for (uint8_t column = 0; column < board_width; column++)
+    struct timespec start;
+    struct timespec stop;
+
+    if (allocateBoard(board, options->random_height, options->random_width))
     {
-      if (board[row][column].current_value == '#')
-      {
-        printf("■");
-      }
-      if (board[row][column].current_value == '.')
-      {
-        printf("·");
-      }
+      return ERROR;
     }
-    printf("║\n");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fillRandomBoardParallel(*board, options->density, options->seed);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    printf("-> Info: Random soup, Rows = %zu, Columns = %zu, filled in %.3f s\n", options->random_height,
+           options->random_width, (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9);
+    return OK;
   }
-  printf("╚");
-  for (uint8_t column = 0; column < board_width; column++)
+
+  if (options->file_path == NULL)
   {
-    printf("═");
+    printf(INFO_DEFAULT_FILE, DEFAULT_CONFIG_PATH);
+    options->file_path = (char*) calloc(sizeof(char), sizeof(DEFAULT_CONFIG_PATH));
+    if (options->file_path == NULL)
+    {
+      return ERROR;
+    }
+    strcpy(options->file_path, DEFAULT_CONFIG_PATH);
   }
-  printf("╝\n");
+  return loadBoardFile(options->file_path, board);
 }
 
 //------------------------------------------------------------------------------
@@ -316,36 +7849,251 @@ void printBoard(Cell **board, int board_height, int board_width)
 //
 int run(int argc, char *argv[])
 {
-  FILE *config_file = NULL;
-  char *file_path = NULL;
-  Cell **board = NULL;
-  uint8_t board_height = 0;
-  uint8_t board_width = 0;
+  Options options = { .soup_width = ENSEMBLE_DEFAULT_SIZE, .soup_height = ENSEMBLE_DEFAULT_SIZE,
+                      .density = ENSEMBLE_DEFAULT_DENSITY, .max_generations = ENSEMBLE_DEFAULT_GENERATIONS,
+                      .keyframe_interval = RECORD_DEFAULT_INTERVAL, .replay_step = 1,
+                      .history_budget = HISTORY_DEFAULT_BUDGET };
+  Board *board = NULL;
+  Recorder *recorder = NULL;
+  History history = { 0 };
+  size_t first_generation;
   size_t step = 0;
+  int paused = 0;
+  int render = 1;
+  long delay = INTERACTIVE_DELAY_MS;
+  struct timespec deadline;
+  Viewport viewport = { .zoom = 1 };
+  PerfCounters update_counters;
+  PerfCounters print_counters;
 
-  if (checkParams(argc, argv, &file_path))
+  if (checkParams(argc, argv, &options))
+  {
+    return ERROR;
+  }
+  signal(SIGINT, handleInterrupt);
+  signal(SIGWINCH, handleResize);
+  if (options.threads == 0)
+  {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    options.threads = (online < 1) ? 1 : (online > MAX_WORKERS) ? MAX_WORKERS : (size_t) online;
+  }
+  if (startWorkerPool(options.threads))
+  {
+    return ERROR;
+  }
+  if (options.bench_path != NULL || options.check_trials != 0 || options.ensemble_path != NULL ||
+      options.soup_count != 0 || options.census_soups != 0 || options.replay_path != NULL)
+  {
+    int result = (options.bench_path != NULL) ? runBenchmark(&options) :
+                 (options.replay_path != NULL) ? runReplay(&options) :
+                 (options.check_trials != 0) ? runCheck(&options) :
+                 (options.census_soups != 0) ? runCensus(&options) : runEnsemble(&options);
+    stopWorkerPool();
+    return result;
+  }
+  if (options.engine == NULL)
+  {
+    // Jumps run unattended and go for speed, interactive runs for the oracle
+    options.engine = &ENGINES[0];
+    for (size_t engine = 0; engine < ENGINE_COUNT && options.generations != 0; engine++)
+    {
+      if (!strcmp(ENGINES[engine].name, JUMP_DEFAULT_ENGINE))
+      {
+        options.engine = &ENGINES[engine];
+      }
+    }
+  }
+  if (loadBoard(&options, &board))
   {
+    stopWorkerPool();
     return ERROR;
   }
-  if (checkConfigFile(&config_file, file_path, &board_height, &board_width))
+  board->topology = options.topology;
+  if (options.record_path != NULL &&
+      startRecording(board, options.record_path, options.keyframe_interval, &recorder))
   {
+    freeBoard(board);
+    stopWorkerPool();
     return ERROR;
   }
-  if (fillBoard(config_file, &board, board_height, board_width))
+  first_generation = board->generation;
+  if (jumpBoard(options.engine, board, options.generations, recorder))
+  {
+    // A partial board under the requested name would pass for the real one
+    printf("-> Error: Interrupted after %zu of %zu generations, nothing written!\n",
+           board->generation - first_generation, options.generations);
+    stopRecording(recorder);
+    freeBoard(board);
+    stopWorkerPool();
+    return ERROR;
+  }
+  if (options.output_path != NULL || (recorder != NULL && options.generations != 0))
+  {
+    int result = (options.output_path == NULL) ? OK :
+                 hasExtension(options.output_path, ".mc") ? writeMacrocellFile(board, options.output_path) :
+                 hasExtension(options.output_path, ".lif") ? writeLife106File(board, options.output_path) :
+                 writeConfigFile(board, options.output_path);
+    if (result == OK && options.analyze_path != NULL)
+    {
+      result = runAnalysis(&options, board);
+    }
+    result |= stopRecording(recorder);
+    freeBoard(board);
+    stopWorkerPool();
+    return result;
+  }
+  if (options.analyze_path != NULL)
+  {
+    int result = runAnalysis(&options, board);
+    result |= stopRecording(recorder);
+    freeBoard(board);
+    stopWorkerPool();
+    return result;
+  }
+  printf("-> Info: Board arena = %zu KiB, on huge pages = %zu KiB\n", board->arena_size / 1024,
+         countHugePageBytes(board) / 1024);
+  if (options.history_budget != 0 && startHistory(board, options.history_budget << 20, &history))
   {
+    stopRecording(recorder);
+    freeBoard(board);
+    stopWorkerPool();
     return ERROR;
   }
+  if (options.perf_counters)
+  {
+    // Without counters the report degrades to timings only
+    openPerfCounters(&update_counters, options.engine->name, worker_pool.size);
+    openPerfCounters(&print_counters, "printBoard", 1);
+  }
   
   sleep(1);
+  viewport.mode = options.render_mode;
+  openTerminal();
   printf("\n============ GOL - Game Of Life ============\n");
-  while(1)
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  addMilliseconds(&deadline, delay);
+  while (keep_running)
   {
-    printf("Step: %zu\n╔", step);
-    printBoard(board, board_height, board_width);
-    updateBoard(board, board_height, board_width);
+    size_t cells = board->height * board->width;
+    int advance = 0;
+
+    if (render)
+    {
+      updateViewport(&viewport, board);
+      printf("Step: %zu\n╔", step);
+      if (options.perf_counters)
+      {
+        startPerfCounters(&print_counters);
+      }
+      printViewport(board, &viewport);
+      if (options.perf_counters)
+      {
+        stopPerfCounters(&print_counters, cells);
+      }
+      render = 0;
+    }
+
+    // The loop sleeps until the next generation is due or a key arrives
+    int key = waitForKey(paused ? NULL : &deadline);
+    switch (key)
+    {
+      case 0:
+        if (!paused && keep_running)
+        {
+          advance = 1;
+          addMilliseconds(&deadline, delay);
+        }
+        break;
+      case KEY_RESIZE:
+        render = 1;
+        break;
+      case ' ':
+        paused = !paused;
+        printf("-> Info: %s\n", paused ? "Paused" : "Resumed");
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        addMilliseconds(&deadline, delay);
+        break;
+      case 'n':
+        advance = 1;
+        break;
+      case 'b':
+        // A recording only moves forward, so stepping back would repeat generations
+        if (recorder != NULL)
+        {
+          printf("-> Info: Cannot step back while recording\n");
+          break;
+        }
+        if (options.history_budget == 0 || stepHistoryBack(&history, board))
+        {
+          printf("-> Info: No earlier generation kept\n");
+          break;
+        }
+        step -= (step > 0);
+        render = 1;
+        break;
+      case '+':
+        delay = (delay / 2 < INTERACTIVE_MIN_DELAY_MS) ? INTERACTIVE_MIN_DELAY_MS : delay / 2;
+        printf("-> Info: %ld ms per generation\n", delay);
+        break;
+      case '-':
+        delay = (delay * 2 > INTERACTIVE_MAX_DELAY_MS) ? INTERACTIVE_MAX_DELAY_MS : delay * 2;
+        printf("-> Info: %ld ms per generation\n", delay);
+        break;
+      case 's':
+        saveSnapshot(board);
+        break;
+      case 'q':
+        keep_running = 0;
+        break;
+      default:
+        render = moveViewport(&viewport, board, key);
+        break;
+    }
+    if (!advance)
+    {
+      continue;
+    }
+
+    if (options.perf_counters)
+    {
+      startPerfCounters(&update_counters);
+    }
+    advanceBoard(options.engine, board, 1);
+    if (options.perf_counters)
+    {
+      stopPerfCounters(&update_counters, cells);
+    }
+    if (recorder != NULL)
+    {
+      recordGeneration(recorder, board);
+    }
+    if (options.history_budget != 0 && pushHistory(&history, board))
+    {
+      // Without memory for the history the run goes on without stepping back
+      freeHistory(&history);
+      options.history_budget = 0;
+    }
     step++;
-    sleep(1);
+    render = 1;
+  }
+  restoreTerminal();
+
+  if (options.perf_counters)
+  {
+    closePerfCounters(&update_counters);
+    closePerfCounters(&print_counters);
+    printPerfCounters(&update_counters);
+    printPerfCounters(&print_counters);
+  }
+  freeHistory(&history);
+  if (stopRecording(recorder))
+  {
+    freeBoard(board);
+    stopWorkerPool();
+    return ERROR;
   }
+  freeBoard(board);
+  stopWorkerPool();
 
   return OK;
 }